@@ -172,8 +172,7 @@ int sc0710_audio_deliver_samples(struct sc0710_dev *dev, struct sc0710_dma_chann
 	sc0710_audio_push_frames(chip, samplesPerChannel, buf, strideBytes, false);
 	chip->last_sample_jiffies = jiffies;
 
-	sc0710_things_per_second_update(&ch->audioSamplesPerSecond,
-					samplesPerChannel * 2);
+	sc0710_stat_add(&ch->stats, SC0710_STAT_SAMPLES, samplesPerChannel * 2);
 
 	return 0;
 }
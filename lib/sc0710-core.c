@@ -27,8 +27,12 @@
 #include <linux/idr.h>
 #include <linux/interrupt.h>
 #include <linux/sysfs.h>
+#include <linux/uaccess.h>
 #include "sc0710.h"
 
+#define CREATE_TRACE_POINTS
+#include "sc0710-trace.h"
+
 /* Binary sysfs write of the 1024-byte HDR→SDR tonemap blob (MK.2 MCU fn 0x63).
  * Empirically on/off patterns; path: .../sc0710/<bdf>/hdr_tonemap */
 static ssize_t hdr_tonemap_write(struct file *filp, struct kobject *kobj,
@@ -117,16 +121,25 @@ unsigned int thread_dma_poll_interval_ms;
 module_param(thread_dma_poll_interval_ms, int, 0644);
 MODULE_PARM_DESC(thread_dma_poll_interval_ms,
 	"DMA service tick in ms. 0 (default) = auto: 100 (watchdog duty) while the "
-	"interrupt-driven service is active, 2 (completion polling) otherwise. An "
-	"explicit value always wins.");
+	"interrupt-driven service is active, completion polling otherwise (see "
+	"poll_adaptive). An explicit value always wins.");
+
+static unsigned int poll_adaptive = 1;
+module_param(poll_adaptive, uint, 0644);
+MODULE_PARM_DESC(poll_adaptive,
+	"Without a usable interrupt, wake the DMA service just after each "
+	"predicted chain completion, from the frame rate and the measured "
+	"completion phase (1=on, default); 0 = fixed 2 ms completion polling.");
 
 unsigned int irq_service = 1;
 module_param(irq_service, uint, 0444);
 MODULE_PARM_DESC(irq_service,
 	"Interrupt-driven DMA completion service (1=on, default): the card's MSI "
-	"wakes the service thread and polling drops to a watchdog tick. 0 = classic "
-	"completion polling. If MSI allocation fails, the driver falls back to "
-	"polling loudly.");
+	"wakes the service thread and polling drops to a watchdog tick. 2 = "
+	"threaded interrupt: the handler's thread services just the channel whose "
+	"engine fired, without waking the service thread. 0 = classic completion "
+	"polling. If MSI allocation fails, the driver falls back to polling "
+	"loudly.");
 
 unsigned int sc0710_debug_mode = 0;
 module_param(sc0710_debug_mode, int, 0644);
@@ -151,9 +164,9 @@ unsigned int zero_copy;
 module_param(zero_copy, uint, 0444);
 MODULE_PARM_DESC(zero_copy,
 	"Experimental: capture DMA writes directly into the streaming client's buffers, "
-	"skipping the per-frame copy (0=off, 1=on). Strict single-client mode: one "
-	"streaming client per video node, buffers whose memory is too fragmented for "
-	"the DMA chain's descriptor budget are refused.");
+	"skipping the per-frame copy (0=off, 1=on). With several streaming clients the "
+	"first one gets the DMA and the others one copy each of its frame; buffers whose "
+	"memory is too fragmented for the DMA chain's descriptor budget are refused.");
 
 unsigned int zc_split = 8;
 module_param(zc_split, uint, 0444);
@@ -164,6 +177,57 @@ MODULE_PARM_DESC(zc_split,
 	"coherent scratch allocations more reliable. 0 = keep the vendor 4 MiB "
 	"segmenting.");
 
+unsigned int stream_scratch;
+module_param(stream_scratch, uint, 0444);
+MODULE_PARM_DESC(stream_scratch,
+	"Back the video DMA scratch ring with streaming mappings of cacheable "
+	"pages, synced per completed chain, instead of coherent allocations "
+	"(0=off, default; 1=on). Helps non-coherent platforms, where coherent "
+	"memory is uncached and every frame copy out of it is slow.");
+
+unsigned int ring_depth;
+module_param(ring_depth, uint, 0444);
+MODULE_PARM_DESC(ring_depth,
+	"Video DMA ring depth in frames (4-16). 0 = auto (default): deep enough "
+	"for about 50 ms of frames at the detected frame rate, within a 96 MiB "
+	"scratch budget - four frames at 60 Hz and below, up to 12 for 1080p240. "
+	"Always bounded by the descriptors that fit one page.");
+
+unsigned int scratch_pool;
+module_param(scratch_pool, uint, 0444);
+MODULE_PARM_DESC(scratch_pool,
+	"Reserve the video DMA scratch ring once at load, sized for the largest "
+	"mode (96 MiB of coherent memory per card; 128 MiB with zero_copy=1 and "
+	"the default zc_split=8, as each frame is then cut into 8 pieces of "
+	"~3 MiB and every piece takes a whole 4 MiB pool segment), and carve every "
+	"resize's ring out of it instead of reallocating: resizes can no longer "
+	"fail on a fragmented host (0=off, default; 1=on). Ignored with "
+	"stream_scratch=1.");
+
+unsigned int fanout_gather = 1;
+module_param(fanout_gather, uint, 0644);
+MODULE_PARM_DESC(fanout_gather,
+	"With two or more clients streaming one node, gather each frame out of the "
+	"DMA scratch ring once into a cacheable staging frame and copy every client "
+	"from there (1=on, default), instead of re-reading the uncached scratch "
+	"allocations once per client (0).");
+
+unsigned int px_workers;
+module_param(px_workers, uint, 0444);
+MODULE_PARM_DESC(px_workers,
+	"Worker threads per device for the host tonemap and interlaced weave, "
+	"each taking one horizontal stripe of the frame (1-16). "
+	"0 (default) = auto, half the online CPUs up to 8; 1 = run them on the "
+	"DMA thread.");
+
+unsigned int frame_handoff = 1;
+module_param(frame_handoff, uint, 0644);
+MODULE_PARM_DESC(frame_handoff,
+	"Snapshot each completed video frame on the DMA thread and tonemap, "
+	"weave and deliver it on a separate delivery worker (1=on, default), so "
+	"chains are re-armed without waiting for the clients' copies; 0 = process "
+	"frames on the DMA thread. Not used with zero_copy=1.");
+
 unsigned int dma_resync_validate_frames = 8;
 module_param(dma_resync_validate_frames, int, 0644);
 MODULE_PARM_DESC(dma_resync_validate_frames,
@@ -189,6 +253,13 @@ module_param(refresh_rate_resync_delay_ms, int, 0644);
 MODULE_PARM_DESC(refresh_rate_resync_delay_ms,
 	"Delay between refresh-rate resync passes in milliseconds");
 
+unsigned int stats_windows[SC0710_STATS_WINDOWS] = { 1, 10, 60 };
+unsigned int stats_windows_count = SC0710_STATS_WINDOWS;
+module_param_array(stats_windows, uint, &stats_windows_count, 0644);
+MODULE_PARM_DESC(stats_windows,
+	"Windows in seconds over which /proc/sc0710-state shows the per-channel "
+	"rates, up to three, 1-60 each (default 1,10,60).");
+
 static unsigned int card[]  = {[0 ... (SC0710_MAXBOARDS - 1)] = UNSET };
 module_param_array(card,  int, NULL, 0444);
 MODULE_PARM_DESC(card, "card type");
@@ -315,6 +386,10 @@ static int sc0710_dev_setup(struct sc0710_dev *dev)
 	mutex_init(&dev->kthread_dma_lock);
 	init_waitqueue_head(&dev->dma_wq);
 	atomic_set(&dev->dma_irq_pending, 0);
+	atomic_set(&dev->irq_ch_pending, 0);
+	init_waitqueue_head(&dev->audio_wq);
+	atomic_set(&dev->audio_irq_pending, 0);
+	atomic64_set(&dev->dma_completions, 0);
 	dev->pixfmt = &sc0710_pixfmts[0];
 	/* Unknown until first sync — forces MCU 0x11 clear/set so a sticky
 	 * hardware tonemap from a prior session cannot double-map SW BGR24. */
@@ -362,26 +437,117 @@ static int sc0710_dev_setup(struct sc0710_dev *dev)
 	return 0;
 }
 
+/* Push a completion stamp for the service pass to pair with its chain.
+ * A ring the service has fallen a whole lap behind on is overwritten; the
+ * consumer notices and skips what it lost. */
+static void sc0710_irq_stamp(struct sc0710_dma_channel *ch, u64 now)
+{
+	u32 head = atomic_read(&ch->irq_ts_head);
+	struct sc0710_irq_stamp *s = &ch->irq_ts_ring[head & (SC0710_IRQ_TS_RING - 1)];
+
+	/* Not allocated yet: nothing to pair it with. */
+	if (!ch->reg_dma_completed_descriptor_count)
+		return;
+
+	s->count = sc_read(ch->dev, 1, ch->reg_dma_completed_descriptor_count);
+	s->ns = now;
+	smp_wmb();
+	atomic_set(&ch->irq_ts_head, head + 1);
+}
+
 /* One interrupt per completed chain (the Completed bit on each chain's last
  * descriptor): count it, sample-and-clear the engine status sources (the
  * read-to-clear deasserts the request so the next event can fire; completion
- * detection itself is writeback-based and derives nothing from them) and
- * wake the DMA service thread. */
+ * detection itself is writeback-based and derives nothing from them),
+ * timestamp the engines that raised it and wake the service context of
+ * each: the audio thread for the audio engine, the DMA thread (or the
+ * IRQ thread) for the video engine. */
 static irqreturn_t sc0710_irq(int irq, void *dev_id)
 {
 	struct sc0710_dev *dev = dev_id;
+	u64 now = ktime_get_ns();
+	u32 fired = 0;
+	u32 st;
 
 	if (!dev->irq_requested)
 		return IRQ_NONE;
 
 	dev->irq_count++;
-	dev->irq_status_seen |= sc_read(dev, 1, 0x1044);
-	dev->irq_status_seen |= sc_read(dev, 1, 0x1144);
 
-	if (dev->irq_service_active) {
+	/* Stamp each completion with the count it brought the engine to:
+	 * that is the frame's capture time, whenever the thread gets to it. */
+	st = sc_read(dev, 1, 0x1044);	/* ch0, video engine */
+	if (st) {
+		sc0710_irq_stamp(&dev->channel[0], now);
+		fired |= BIT(0);
+	}
+	dev->irq_status_seen |= st;
+	st = sc_read(dev, 1, 0x1144);	/* ch1, audio engine */
+	if (st) {
+		sc0710_irq_stamp(&dev->channel[1], now);
+		fired |= BIT(1);
+	}
+	dev->irq_status_seen |= st;
+
+	/* No engine owned up: let both contexts look. */
+	if (!fired)
+		fired = BIT(0) | BIT(1);
+
+	if (!dev->irq_service_active)
+		return IRQ_HANDLED;
+
+	if (fired & BIT(1)) {
+		atomic_set(&dev->audio_irq_pending, 1);
+		wake_up(&dev->audio_wq);
+	}
+
+	if (!(fired & BIT(0)))
+		return IRQ_HANDLED;
+
+	if (dev->irq_threaded) {
+		atomic_or(BIT(0), &dev->irq_ch_pending);
+		return IRQ_WAKE_THREAD;
+	}
+
+	atomic_set(&dev->dma_irq_pending, 1);
+	wake_up(&dev->dma_wq);
+	return IRQ_HANDLED;
+}
+
+/* Threaded service (irq_service=2): the handler's thread services the
+ * video channel, so a frame is picked up without a wakeup of the DMA
+ * thread. Audio stays on its own thread. The DMA thread keeps its
+ * watchdog tick, the missed-interrupt tripwire and the resyncs; it is
+ * woken when a pass asks for a resync. */
+static irqreturn_t sc0710_irq_thread(int irq, void *dev_id)
+{
+	struct sc0710_dev *dev = dev_id;
+	unsigned long pending;
+	int i, ret, consumed = 0;
+
+	mutex_lock(&dev->kthread_dma_lock);
+	/* Claimed under the lock: a watchdog pass holding it still sees
+	 * these as announced and does not count them as missed. */
+	pending = atomic_xchg(&dev->irq_ch_pending, 0);
+	if (thread_dma_active && !dev->reconfig_in_progress &&
+	    !READ_ONCE(dev->disconnected)) {
+		for_each_set_bit(i, &pending, SC0710_MAX_CHANNELS) {
+			if (!dev->channel[i].enabled)
+				continue;
+			ret = sc0710_dma_channel_service(&dev->channel[i]);
+			if (ret > 0)
+				consumed += ret;
+		}
+	}
+	atomic64_add(consumed, &dev->dma_completions);
+	dev->irq_thread_runs++;
+	mutex_unlock(&dev->kthread_dma_lock);
+
+	if (READ_ONCE(dev->tear_resync_pending)) {
 		atomic_set(&dev->dma_irq_pending, 1);
 		wake_up(&dev->dma_wq);
 	}
+
 	return IRQ_HANDLED;
 }
 
@@ -411,6 +577,76 @@ static void sc0710_dev_unregister(struct sc0710_dev *dev)
 }
 
 #ifdef CONFIG_PROC_FS
+/* Channel totals, then one rate line per stats_windows= entry. */
+static void sc0710_proc_stats_show(struct seq_file *m, struct sc0710_dma_channel *ch)
+{
+	u64 tot[SC0710_STAT_COUNT], rate[SC0710_STAT_COUNT];
+	u32 n = min_t(u32, stats_windows_count, SC0710_STATS_WINDOWS);
+	u32 fps_rem, drop_rem, w;
+	char label[16];
+	u64 fps, drops;
+	int i;
+
+	sc0710_stats_read(&ch->stats, tot);
+	seq_printf(m, "      totals: %llu bytes, %llu frames, %llu descriptors, %llu drops\n",
+		tot[SC0710_STAT_BYTES], tot[SC0710_STAT_FRAMES],
+		tot[SC0710_STAT_DESCS], tot[SC0710_STAT_DROPS]);
+	if (ch->mediatype == CHTYPE_VIDEO)
+		seq_printf(m, "              %llu copied, %llu zero-copy\n",
+			tot[SC0710_STAT_COPIES], tot[SC0710_STAT_ZC_HITS]);
+	else
+		seq_printf(m, "              %llu samples\n", tot[SC0710_STAT_SAMPLES]);
+
+	for (i = 0; i < n; i++) {
+		w = clamp_t(u32, stats_windows[i], 1, SC0710_STATS_MAX_WINDOW);
+		sc0710_stats_rates(&ch->stats, w, tot, rate);
+		fps = div_u64_rem(rate[SC0710_STAT_FRAMES], 100, &fps_rem);
+		drops = div_u64_rem(rate[SC0710_STAT_DROPS], 100, &drop_rem);
+		snprintf(label, sizeof(label), "rate %us", w);
+
+		if (ch->mediatype == CHTYPE_VIDEO)
+			seq_printf(m, "%12s: %llu Mb/s, %llu.%02u fps, %llu desc/s, %llu.%02u drops/s\n",
+				label, div_u64(rate[SC0710_STAT_BYTES] * 8, 100000000),
+				fps, fps_rem, div_u64(rate[SC0710_STAT_DESCS], 100),
+				drops, drop_rem);
+		else
+			seq_printf(m, "%12s: %llu kb/s, %llu.%02u periods/s, %llu Hz, %llu.%02u drops/s\n",
+				label, div_u64(rate[SC0710_STAT_BYTES] * 8, 100000),
+				fps, fps_rem, div_u64(rate[SC0710_STAT_SAMPLES], 200),
+				drops, drop_rem);
+	}
+}
+
+/* One latency histogram: summary, then the non-empty log2 buckets by
+ * upper bound. One still waiting for its writer to act on a reset reads
+ * as empty. */
+static void sc0710_proc_lat_show(struct seq_file *m, const char *name,
+	const struct sc0710_lat_hist *h)
+{
+	static const struct sc0710_lat_hist empty;
+	int b;
+
+	if (READ_ONCE(h->reset_pending))
+		h = &empty;
+
+	seq_printf(m, "%12s: n %llu, avg %llu us, max %llu us\n", name, h->count,
+		h->count ? div_u64(div64_u64(h->sum_ns, h->count), 1000) : 0,
+		div_u64(h->max_ns, 1000));
+	if (!h->count)
+		return;
+
+	seq_puts(m, "             ");
+	for (b = 0; b < SC0710_LAT_BUCKETS; b++) {
+		if (!h->bucket[b])
+			continue;
+		if (b == SC0710_LAT_BUCKETS - 1)
+			seq_printf(m, " >=%uus:%llu", 1u << b, h->bucket[b]);
+		else
+			seq_printf(m, " <%uus:%llu", 2u << b, h->bucket[b]);
+	}
+	seq_puts(m, "\n");
+}
+
 static int sc0710_proc_state_show(struct seq_file *m, void *v)
 {
 	struct sc0710_dma_channel *ch;
@@ -428,10 +664,17 @@ static int sc0710_proc_state_show(struct seq_file *m, void *v)
 		seq_printf(m, "%s\n", dev->name);
 
 		if (dev->irq_requested)
-			seq_printf(m, "         irq: delivered %llu, missed %llu, completions %llu, status %08x%s\n",
-				dev->irq_count, dev->irq_missed, dev->dma_completions,
+			seq_printf(m, "         irq: %s, delivered %llu, missed %llu, completions %llu, status %08x%s\n",
+				dev->irq_threaded ? "threaded" : "wakes dma thread",
+				dev->irq_count, dev->irq_missed,
+				atomic64_read(&dev->dma_completions),
 				dev->irq_status_seen,
 				dev->irq_dead ? " [IRQ LOST - polling]" : "");
+		if (dev->resync_count)
+			seq_printf(m, " mode switch: %llu resyncs, last %llu us, avg %llu us, max %llu us\n",
+				dev->resync_count, div_u64(dev->resync_last_ns, 1000),
+				div_u64(div64_u64(dev->resync_sum_ns, dev->resync_count), 1000),
+				div_u64(dev->resync_max_ns, 1000));
 
 		/* Cached state only: this file is world-readable, so its read path
 		 * must not run I2C or trigger a DMA reconfig; the HDMI poll
@@ -466,6 +709,34 @@ static int sc0710_proc_state_show(struct seq_file *m, void *v)
 			sc0710_want_hw_tonemap(dev) ? "hw-tonemap" :
 			sc0710_want_sw_tonemap(dev) ? "sw-tonemap" :
 			(sc0710_prefer_hdr_bgr24(dev) ? "passthrough" : "sdr"));
+		if (dev->px.wq) {
+			seq_printf(m, "  px workers: %u, dispatches %llu, wall avg %llu us, last %llu us, max %llu us\n",
+				dev->px.workers, dev->px.dispatches,
+				dev->px.dispatches ?
+				div64_u64(dev->px.wall_total_ns, dev->px.dispatches) / 1000 : 0,
+				dev->px.wall_last_ns / 1000, dev->px.wall_max_ns / 1000);
+			for (i = 0; i < dev->px.workers; i++) {
+				struct sc0710_px_stripe s;
+
+				spin_lock(&dev->px.stats_lock);
+				s = dev->px.stripe[i];
+				spin_unlock(&dev->px.stats_lock);
+				seq_printf(m, "   stripe[%d]: runs %llu, avg %llu us, last %llu us, max %llu us\n",
+					i, s.runs,
+					s.runs ? div64_u64(s.total_ns, s.runs) / 1000 : 0,
+					s.last_ns / 1000, s.max_ns / 1000);
+			}
+		} else {
+			struct sc0710_px_stripe s;
+
+			spin_lock(&dev->px.stats_lock);
+			s = dev->px.stripe[0];
+			spin_unlock(&dev->px.stats_lock);
+			seq_printf(m, "  px workers: inline, runs %llu, avg %llu us, max %llu us\n",
+				s.runs,
+				s.runs ? div64_u64(s.total_ns, s.runs) / 1000 : 0,
+				s.max_ns / 1000);
+		}
 		seq_printf(m, "     procamp: brightness  %d\n", dev->brightness);
 		seq_printf(m, "     procamp: contrast    %d\n", dev->contrast);
 		seq_printf(m, "     procamp: saturation  %d\n", dev->saturation);
@@ -492,24 +763,84 @@ static int sc0710_proc_state_show(struct seq_file *m, void *v)
 			seq_printf(m, "  ch[%d]\n", i);
 			seq_printf(m, "        type: %s\n",
 				ch->mediatype == CHTYPE_VIDEO ? "VIDEO" : "AUDIO");
-			seq_printf(m, "     dma bps: %lld (Mb/ps %lld) (MB/ps %lld)\n",
-				sc0710_things_per_second_query(&ch->bitsPerSecond),
-				sc0710_things_per_second_query(&ch->bitsPerSecond) / 1000000,
-				sc0710_things_per_second_query(&ch->bitsPerSecond) / 1000000 / 8);
-			seq_printf(m, "    descr ps: %lld\n",
-				sc0710_things_per_second_query(&ch->descPerSecond));
+			seq_printf(m, "     scratch: %s\n",
+				ch->chains[0].streaming ? "streaming" : "coherent");
+			seq_printf(m, "        ring: %u chains of %u bytes\n",
+				ch->numDescriptorChains, ch->buf_size);
+			if (ch->resize_recut + ch->resize_rebuilt)
+				seq_printf(m, "      resize: %llu re-cut, %llu rebuilt, last %llu us, max %llu us\n",
+					ch->resize_recut, ch->resize_rebuilt,
+					div_u64(ch->resize_last_ns, 1000),
+					div_u64(ch->resize_max_ns, 1000));
+			if (ch->pool.nsegs)
+				seq_printf(m, "        pool: %u MiB reserved, %u of %u segments in use\n",
+					(ch->pool.nsegs * ch->pool.seg_size) >> 20,
+					min(ch->pool.next_seg + (ch->pool.next_off ? 1 : 0),
+						ch->pool.nsegs),
+					ch->pool.nsegs);
+			sc0710_proc_stats_show(m, ch);
+
+			if (ch->mediatype == CHTYPE_VIDEO) {
+				u64 rd = atomic64_read(&ch->scratch_bytes_read);
+
+				seq_printf(m, "  scratch rd: %llu bytes/frame (%llu bytes, %llu frames out)\n",
+					ch->frames_out ? div64_u64(rd, ch->frames_out) : 0,
+					rd, ch->frames_out);
+				seq_printf(m, "       weave: %llu frames in place\n",
+					ch->weave_direct);
+				seq_printf(m, "     handoff: %s, queued %u/%u, frames %llu, drops %llu\n",
+					(frame_handoff && !zero_copy && dev->dq_wq) ? "on" : "off",
+					READ_ONCE(ch->handoff_count), SC0710_HANDOFF_SLOTS,
+					ch->handoff_frames, ch->handoff_drops);
+			}
 
-			if (zero_copy && ch->mediatype == CHTYPE_VIDEO) {
-				seq_printf(m, "   zc frames: %llu direct, %llu copied\n",
-					ch->zc_frames_direct, ch->zc_frames_copied);
-				seq_printf(m, "    zc flips: %llu, stale events: %llu, stale descriptors: %llu%s\n",
-					ch->zc_wbm_flips, ch->zc_stale_events, ch->zc_stale_descs,
-					ch->zc_stale_trip ? " [TRIPPED - zero-copy disabled]" : "");
+			/* Zero-copy's credit-gated ring cannot overrun. */
+			if (!zero_copy || ch->mediatype != CHTYPE_VIDEO)
+				seq_printf(m, "     dropped: %llu frames (ring overrun %llu, %llu this session; handoff full %llu)\n",
+					ch->ring_overruns + ch->handoff_drops,
+					ch->ring_overruns, ch->ring_lost_session,
+					ch->handoff_drops);
+			seq_printf(m, "   ts source: irq %llu, poll %llu, gaps %llu\n",
+				ch->ts_from_irq, ch->ts_from_poll, ch->ts_gaps);
+			seq_printf(m, "   ts jitter: period %llu us, avg %llu us, max %llu us\n",
+				div_u64(ch->ts_period_ns, 1000),
+				ch->ts_jitter_samples ?
+					div_u64(div64_u64(ch->ts_jitter_sum_ns,
+						ch->ts_jitter_samples), 1000) : 0,
+				div_u64(ch->ts_jitter_max_ns, 1000));
+			seq_printf(m, "              <50us %llu, <100us %llu, <250us %llu, <500us %llu, <1ms %llu, <2ms %llu, <5ms %llu, more %llu\n",
+				ch->ts_jitter_hist[0], ch->ts_jitter_hist[1],
+				ch->ts_jitter_hist[2], ch->ts_jitter_hist[3],
+				ch->ts_jitter_hist[4], ch->ts_jitter_hist[5],
+				ch->ts_jitter_hist[6], ch->ts_jitter_hist[7]);
+			sc0710_proc_lat_show(m, "lat service", &ch->lat_service);
+			if (ch->poll_wakes)
+				seq_printf(m, "    dma poll: %llu timed wakes, %llu found the chain on time, %llu early\n",
+					ch->poll_wakes, ch->poll_on_time, ch->poll_early_total);
+			if (ch->mediatype == CHTYPE_VIDEO) {
+				sc0710_proc_lat_show(m, "lat detect", &ch->lat_detect);
+				sc0710_proc_lat_show(m, "lat deliver", &ch->lat_deliver);
+				sc0710_proc_lat_show(m, "lat dqbuf", &ch->lat_dqbuf);
 			}
+			seq_printf(m, "    svc hold: last %llu us, max %llu us\n",
+				div_u64(ch->service_hold_last_ns, 1000),
+				div_u64(ch->service_hold_max_ns, 1000));
 
-			if (ch->mediatype == CHTYPE_AUDIO) {
-				seq_printf(m, "  aud sam ps: %lld\n",
-					sc0710_things_per_second_query(&ch->audioSamplesPerSecond) / 2);
+			if (zero_copy && ch->mediatype == CHTYPE_VIDEO) {
+				seq_printf(m, "   zc frames: %llu direct, %llu copied, %llu shared, %llu tonemapped\n",
+					ch->zc_frames_direct, ch->zc_frames_copied,
+					ch->zc_frames_shared, ch->zc_frames_tonemapped);
+				seq_printf(m, "    zc flips: %llu, stale events: %llu, stale descriptors: %llu\n",
+					ch->zc_wbm_flips, ch->zc_stale_events, ch->zc_stale_descs);
+				seq_printf(m, "   zc import: %llu direct, %llu copied, %llu unmapped errors; carves refused %llu\n",
+					ch->zc_import_direct, ch->zc_import_copied,
+					(u64)atomic64_read(&ch->zc_import_errors),
+					ch->zc_carve_rejects);
+				seq_printf(m, "    zc state: %s", sc0710_zc_state_ascii(ch->zc_state));
+				if (ch->zc_state == ZC_STATE_PROBATION)
+					seq_printf(m, " (%u laps left)", ch->zc_probation_laps);
+				seq_printf(m, ", trips %u (%u recent)\n",
+					ch->zc_trips, ch->zc_trips_recent);
 			}
 		}
 
@@ -569,6 +900,42 @@ static int sc0710_proc_state_open(struct inode *inode, struct file *filp)
 	return single_open(filp, sc0710_proc_state_show, NULL);
 }
 
+/* "reset" clears every channel's latency histograms. */
+static ssize_t sc0710_proc_state_write(struct file *filp, const char __user *ubuf,
+	size_t len, loff_t *off)
+{
+	struct sc0710_dev *dev;
+	struct list_head *list;
+	char cmd[16];
+	size_t n = min(len, sizeof(cmd) - 1);
+	int i;
+
+	if (copy_from_user(cmd, ubuf, n))
+		return -EFAULT;
+	cmd[n] = 0;
+	if (!sysfs_streq(cmd, "reset"))
+		return -EINVAL;
+
+	mutex_lock(&devlist);
+	list_for_each(list, &sc0710_devlist) {
+		dev = list_entry(list, struct sc0710_dev, devlist);
+		/* The service loop, the delivery worker and DQBUF record
+		 * without a lock shared with us: have each histogram's own
+		 * writer clear it. */
+		for (i = 0; i < SC0710_MAX_CHANNELS; i++) {
+			struct sc0710_dma_channel *ch = &dev->channel[i];
+
+			WRITE_ONCE(ch->lat_detect.reset_pending, true);
+			WRITE_ONCE(ch->lat_deliver.reset_pending, true);
+			WRITE_ONCE(ch->lat_dqbuf.reset_pending, true);
+			WRITE_ONCE(ch->lat_service.reset_pending, true);
+		}
+	}
+	mutex_unlock(&devlist);
+
+	return len;
+}
+
 #if LINUX_VERSION_CODE <= KERNEL_VERSION(4,0,0)
 static struct file_operations sc0710_proc_fops = {
 	.open		= sc0710_proc_open,
@@ -580,6 +947,7 @@ static struct file_operations sc0710_proc_fops = {
 static struct file_operations sc0710_proc_state_fops = {
 	.open		= sc0710_proc_state_open,
 	.read		= seq_read,
+	.write		= sc0710_proc_state_write,
 	.llseek		= seq_lseek,
 	.release	= single_release,
 };
@@ -594,6 +962,7 @@ static struct proc_ops sc0710_proc_fops = {
 static struct proc_ops sc0710_proc_state_fops = {
 	.proc_open		= sc0710_proc_state_open,
 	.proc_read		= seq_read,
+	.proc_write		= sc0710_proc_state_write,
 	.proc_lseek		= seq_lseek,
 	.proc_release	= single_release,
 };
@@ -604,12 +973,13 @@ static int sc0710_proc_create(void)
 	struct proc_dir_entry *pe;
 
 	/* Root-only: the raw register dump has no business being world-readable.
-	 * sc0710-cli only reads sc0710-state, which stays 0444. */
+	 * sc0710-cli only reads sc0710-state, which stays world-readable;
+	 * root may write "reset" to it to clear the latency histograms. */
 	pe = proc_create("sc0710", S_IRUSR, NULL, &sc0710_proc_fops);
 	if (!pe)
 		return -ENOMEM;
 
-	pe = proc_create("sc0710-state", S_IRUGO, NULL, &sc0710_proc_state_fops);
+	pe = proc_create("sc0710-state", S_IRUGO | S_IWUSR, NULL, &sc0710_proc_state_fops);
 	if (!pe) {
 		remove_proc_entry("sc0710", NULL);
 		return -ENOMEM;
@@ -650,6 +1020,190 @@ static bool sc0710_dma_watchdog_check_locked(struct sc0710_dev *dev)
 	return false;
 }
 
+/* Adaptive completion polling. Without a usable interrupt, a fixed 2 ms
+ * tick means 500 wakeups a second for a 24p source and up to 2 ms of
+ * detection latency at 240 Hz. Instead each running channel keeps an
+ * estimate of when its last chain completed and of the chain period (the
+ * measured capture interval, else the detected format's frame rate, for
+ * video; measured for audio), and the thread sleeps on an hrtimer until
+ * just after the earliest predicted completion. A wake that finds nothing
+ * re-polls in short steps until the chain lands, which re-measures the
+ * phase; one that finds it on time pulls the estimate slightly earlier,
+ * so the phase keeps being probed instead of drifting late. A channel
+ * with no estimate yet is polled on the fixed tick. */
+#define SC0710_POLL_TICK_NS	(2 * NSEC_PER_MSEC)
+#define SC0710_POLL_MAX_NS	(100 * NSEC_PER_MSEC)
+
+static u64 sc0710_dma_poll_period(struct sc0710_dma_channel *ch)
+{
+	const struct sc0710_format *fmt;
+
+	if (ch->mediatype != CHTYPE_VIDEO)
+		return ch->poll_period_ns;
+	if (ch->ts_period_ns)
+		return ch->ts_period_ns;
+	fmt = READ_ONCE(ch->dev->fmt);
+	if (fmt && fmt->fpsX100)
+		return div_u64(100ULL * NSEC_PER_SEC, fmt->fpsX100);
+	return 0;
+}
+
+/* Re-poll step while a predicted chain is late; the first wake lands
+ * half a step after the prediction. */
+static u64 sc0710_dma_poll_step(u64 period)
+{
+	return clamp_t(u64, period >> 5, 100 * NSEC_PER_USEC, NSEC_PER_MSEC);
+}
+
+/* Fold a pass that started at now, since after the previous one, into
+ * the channel's completion estimate. */
+static void sc0710_dma_poll_update(struct sc0710_dma_channel *ch, u64 now, u64 since)
+{
+	u32 count = READ_ONCE(ch->dma_completed_descriptor_count_last);
+	u64 period = sc0710_dma_poll_period(ch);
+	u64 expected = 0, est, interval;
+	u32 chains = 0;
+
+	if (ch->state != STATE_RUNNING) {
+		ch->poll_anchor_ns = 0;
+		ch->poll_count = count;
+		return;
+	}
+
+	if (ch->poll_anchor_ns && period)
+		expected = ch->poll_anchor_ns + period;
+
+	if (count == ch->poll_count) {
+		if (expected && now >= expected) {
+			ch->poll_early++;
+			ch->poll_early_total++;
+			/* A whole period late: the source stopped or changed;
+			 * start over from the next completion. */
+			if (now > expected + period)
+				ch->poll_anchor_ns = 0;
+		}
+		return;
+	}
+
+	if (ch->sg_total_descriptors)
+		chains = div_u64((u64)(count - ch->poll_count) * ch->numDescriptorChains +
+			ch->sg_total_descriptors / 2, ch->sg_total_descriptors);
+	ch->poll_count = count;
+
+	if (expected && chains == 1 && !ch->poll_early && now >= expected) {
+		/* Found by the first wake after the prediction. */
+		est = expected - (sc0710_dma_poll_step(period) >> 2);
+		ch->poll_on_time++;
+	} else {
+		/* Landed some time since the previous pass. */
+		est = now - (min(since, period ? period : since) >> 1);
+	}
+
+	/* Chain period, for the channels without a frame rate. */
+	if (ch->poll_anchor_ns && chains == 1 && est > ch->poll_anchor_ns) {
+		interval = est - ch->poll_anchor_ns;
+		if (!ch->poll_period_ns || ch->poll_rejects >= 4) {
+			ch->poll_period_ns = interval;
+			ch->poll_rejects = 0;
+		} else if (interval * 2 < ch->poll_period_ns ||
+			   interval * 2 > ch->poll_period_ns * 3) {
+			ch->poll_rejects++;
+		} else {
+			ch->poll_period_ns = ch->poll_period_ns -
+				(ch->poll_period_ns >> 3) + (interval >> 3);
+			ch->poll_rejects = 0;
+		}
+	}
+
+	ch->poll_anchor_ns = est;
+	ch->poll_early = 0;
+}
+
+/* How long the thread servicing one media type sleeps from now: until
+ * just after the earliest predicted completion, a re-poll step if one is
+ * overdue. */
+static u64 sc0710_dma_poll_delay(struct sc0710_dev *dev,
+	enum sc0710_channel_type_e type, u64 now)
+{
+	u64 delay = SC0710_POLL_MAX_NS;
+	u64 period, step, wake;
+	bool running = false;
+	int i;
+
+	for (i = 0; i < SC0710_MAX_CHANNELS; i++) {
+		struct sc0710_dma_channel *ch = &dev->channel[i];
+
+		if (!ch->enabled || ch->mediatype != type ||
+		    ch->state != STATE_RUNNING)
+			continue;
+		running = true;
+
+		period = sc0710_dma_poll_period(ch);
+		if (!ch->poll_anchor_ns || !period) {
+			delay = min_t(u64, delay, SC0710_POLL_TICK_NS);
+			continue;
+		}
+		step = sc0710_dma_poll_step(period);
+		wake = ch->poll_anchor_ns + period + (step >> 1);
+		delay = min(delay, wake > now ? wake - now : step);
+	}
+
+	return running ? delay : SC0710_POLL_TICK_NS;
+}
+
+/* Fold an adaptive pass that started at now, since after the previous
+ * one, into the estimates of one media type's channels; returns how
+ * long to sleep next. */
+static u64 sc0710_dma_poll_pass(struct sc0710_dev *dev,
+	enum sc0710_channel_type_e type, u64 now, u64 since)
+{
+	int i;
+
+	for (i = 0; i < SC0710_MAX_CHANNELS; i++) {
+		struct sc0710_dma_channel *ch = &dev->channel[i];
+
+		if (!ch->enabled || ch->mediatype != type)
+			continue;
+		ch->poll_wakes++;
+		sc0710_dma_poll_update(ch, now, since);
+	}
+
+	return sc0710_dma_poll_delay(dev, type, ktime_get_ns());
+}
+
+/* Sleep until a service thread's next pass. Returns true when the wake
+ * was the adaptive poll's hrtimer (or an interrupt during it). */
+static bool sc0710_dma_thread_wait(struct sc0710_dev *dev,
+	wait_queue_head_t *wq, atomic_t *pending, u64 poll_delay)
+{
+	unsigned int ms = thread_dma_poll_interval_ms;
+
+	/* 0 = auto: watchdog duty while the interrupt-driven service
+	 * is healthy, classic completion polling otherwise. An explicit
+	 * value always wins (the runtime workaround knob if interrupts
+	 * misbehave); the >=1 clamp keeps a written 0 from busy-looping
+	 * the thread. */
+	if (ms == 0) {
+		if (dev->irq_service_active && !dev->irq_dead) {
+			ms = 100;
+		} else if (poll_adaptive) {
+			/* Jiffies can't express a sub-millisecond wake. */
+			wait_event_interruptible_hrtimeout(*wq,
+				atomic_read(pending) || kthread_should_stop(),
+				ns_to_ktime(poll_delay));
+			try_to_freeze();
+			return true;
+		} else {
+			ms = 2;
+		}
+	}
+
+	wait_event_freezable_timeout(*wq,
+		atomic_read(pending) || kthread_should_stop(),
+		msecs_to_jiffies(max_t(unsigned int, ms, 1)));
+	return false;
+}
+
 static int sc0710_thread_dma_function(void *data)
 {
 	struct sc0710_dev *dev = data;
@@ -657,6 +1211,8 @@ static int sc0710_thread_dma_function(void *data)
 	int tear_requested_resync;
 	bool was_inactive = false;
 	int missed_streak = 0;
+	u64 poll_delay = SC0710_POLL_TICK_NS;
+	u64 now = 0, poll_last = 0;
 	int i;
 
 	dprintk(1, "%s() Started\n", __func__);
@@ -666,20 +1222,14 @@ static int sc0710_thread_dma_function(void *data)
 	set_freezable();
 
 	while (1) {
-		unsigned int ms = thread_dma_poll_interval_ms;
+		bool adaptive;
 		bool from_irq;
 		int consumed;
 
-		/* 0 = auto: watchdog duty while the interrupt-driven service
-		 * is healthy, classic completion polling otherwise. An explicit
-		 * value always wins (the runtime workaround knob if interrupts
-		 * misbehave); the >=1 clamp keeps a written 0 from busy-looping
-		 * this thread. */
-		if (ms == 0)
-			ms = (dev->irq_service_active && !dev->irq_dead) ? 100 : 2;
-		wait_event_freezable_timeout(dev->dma_wq,
-			atomic_read(&dev->dma_irq_pending) || kthread_should_stop(),
-			msecs_to_jiffies(max_t(unsigned int, ms, 1)));
+		adaptive = sc0710_dma_thread_wait(dev, &dev->dma_wq,
+			&dev->dma_irq_pending, poll_delay);
+		if (adaptive)
+			now = ktime_get_ns();
 
 		/* Always consume the wake flag, even on paused or exiting
 		 * passes - a set flag would turn the wait into a busy loop.
@@ -701,7 +1251,9 @@ static int sc0710_thread_dma_function(void *data)
 		consumed = 0;
 		mutex_lock(&dev->kthread_dma_lock);
 		if (!dev->reconfig_in_progress) {
-			consumed = sc0710_dma_channels_service(dev);
+			consumed = sc0710_dma_channels_service(dev, CHTYPE_VIDEO);
+			if (consumed > 0)
+				atomic64_add(consumed, &dev->dma_completions);
 			need_dma_resync = sc0710_dma_watchdog_check_locked(dev);
 			if (!need_dma_resync && dev->tear_resync_pending) {
 				dev->tear_resync_pending = 0;
@@ -713,8 +1265,13 @@ static int sc0710_thread_dma_function(void *data)
 		}
 		mutex_unlock(&dev->kthread_dma_lock);
 
-		if (consumed > 0)
-			dev->dma_completions += consumed;
+		if (adaptive) {
+			poll_delay = sc0710_dma_poll_pass(dev, CHTYPE_VIDEO, now,
+				poll_last ? now - poll_last : poll_delay);
+			poll_last = now;
+		} else {
+			poll_last = 0;
+		}
 
 		/* Interrupt-loss tripwire: a timeout pass that still found
 		 * completed work means the interrupt for that work never
@@ -729,13 +1286,14 @@ static int sc0710_thread_dma_function(void *data)
 		if (dev->irq_service_active && !dev->irq_dead &&
 		    thread_dma_poll_interval_ms == 0 &&
 		    consumed > 0 && !from_irq && !was_inactive &&
-		    !atomic_read(&dev->dma_irq_pending)) {
+		    !atomic_read(&dev->dma_irq_pending) &&
+		    !atomic_read(&dev->irq_ch_pending)) {
 			dev->irq_missed++;
 			printk_ratelimited(KERN_WARNING "%s: completed DMA work found by the watchdog, not an interrupt (missed %llu)\n",
 				dev->name, dev->irq_missed);
 			if (++missed_streak >= 3) {
 				dev->irq_dead = true;
-				printk(KERN_ERR "%s: interrupt delivery lost - falling back to 2 ms polling for this session\n",
+				printk(KERN_ERR "%s: interrupt delivery lost - falling back to completion polling for this session\n",
 					dev->name);
 			}
 		} else if (from_irq || consumed == 0) {
@@ -760,6 +1318,58 @@ static int sc0710_thread_dma_function(void *data)
 	return 0;
 }
 
+/* Audio service context. Audio chains are never resized and the resyncs
+ * only stop video, so a pass needs the channel's own lock and nothing of
+ * the DMA thread's: a period is consumed as soon as its interrupt (or
+ * the poll) says so, whatever the video thread is in the middle of. The
+ * watchdog, the missed-interrupt tripwire and the resyncs stay with the
+ * DMA thread. */
+static int sc0710_thread_audio_function(void *data)
+{
+	struct sc0710_dev *dev = data;
+	u64 poll_delay = SC0710_POLL_TICK_NS;
+	u64 now = 0, poll_last = 0;
+	bool adaptive;
+	int consumed;
+
+	dprintk(1, "%s() Started\n", __func__);
+
+	msleep(2000);
+
+	set_freezable();
+
+	while (1) {
+		adaptive = sc0710_dma_thread_wait(dev, &dev->audio_wq,
+			&dev->audio_irq_pending, poll_delay);
+		if (adaptive)
+			now = ktime_get_ns();
+
+		/* Consumed on every pass, like the DMA thread's flag. */
+		atomic_xchg(&dev->audio_irq_pending, 0);
+
+		if (kthread_should_stop())
+			break;
+
+		if (thread_dma_active == 0 || READ_ONCE(dev->disconnected))
+			continue;
+
+		consumed = sc0710_dma_channels_service(dev, CHTYPE_AUDIO);
+		if (consumed > 0)
+			atomic64_add(consumed, &dev->dma_completions);
+
+		if (adaptive) {
+			poll_delay = sc0710_dma_poll_pass(dev, CHTYPE_AUDIO, now,
+				poll_last ? now - poll_last : poll_delay);
+			poll_last = now;
+		} else {
+			poll_last = 0;
+		}
+	}
+
+	dprintk(1, "%s() Stopped\n", __func__);
+	return 0;
+}
+
 static int sc0710_thread_hdmi_function(void *data)
 {
 	struct sc0710_dev *dev = data;
@@ -898,14 +1508,18 @@ static int sc0710_initdev(struct pci_dev *pci_dev,
 	 * and demotes polling to a watchdog tick. MSI only - a shared INTx
 	 * line with a wake-only handler would mask co-devices. */
 	if (irq_service) {
+		dev->irq_threaded = irq_service == 2;
 		if (pci_alloc_irq_vectors(pci_dev, 1, 1, PCI_IRQ_MSI) == 1 &&
-		    pci_request_irq(pci_dev, 0, sc0710_irq, NULL, dev,
-				    "%s", dev->name) == 0) {
+		    pci_request_irq(pci_dev, 0, sc0710_irq,
+				    dev->irq_threaded ? sc0710_irq_thread : NULL,
+				    dev, "%s", dev->name) == 0) {
 			dev->irq_requested = true;
 			dev->irq_service_active = true;
-			printk(KERN_INFO "%s: interrupt-driven DMA service: MSI, irq %d\n",
-				dev->name, pci_irq_vector(pci_dev, 0));
+			printk(KERN_INFO "%s: interrupt-driven DMA service: MSI, irq %d%s\n",
+				dev->name, pci_irq_vector(pci_dev, 0),
+				dev->irq_threaded ? ", threaded" : "");
 		} else {
+			dev->irq_threaded = false;
 			pci_free_irq_vectors(pci_dev);
 			printk(KERN_WARNING "%s: could not request the interrupt line (MSI), falling back to polling\n",
 				dev->name);
@@ -933,6 +1547,15 @@ static int sc0710_initdev(struct pci_dev *pci_dev,
 	printk(KERN_INFO "sc0710 device at %s\n", pci_name(pci_dev));
 	printk(KERN_INFO "sc0710 page-size %lu bytes\n", PAGE_SIZE);
 
+	/* Non-fatal: without a pool, frames are processed inline. */
+	sc0710_px_pool_init(dev);
+
+	/* Non-fatal likewise: without it, frames are delivered inline. */
+	dev->dq_wq = alloc_ordered_workqueue("sc0710-dq/%d", WQ_HIGHPRI, dev->nr);
+	if (!dev->dq_wq)
+		printk(KERN_WARNING "%s: frame delivery worker unavailable, delivering frames on the DMA thread\n",
+			dev->name);
+
 	err = sc0710_dma_channels_alloc(dev);
 	if (err < 0) {
 		printk(KERN_ERR "%s: DMA channel allocation failed (%d), aborting probe\n",
@@ -971,6 +1594,16 @@ static int sc0710_initdev(struct pci_dev *pci_dev,
 	list_add_tail(&dev->devlist, &sc0710_devlist);
 	mutex_unlock(&devlist);
 
+	sc0710_stats_start(dev);
+
+	/* Non-fatal: /proc/sc0710-state still carries the same counters. */
+	err = sc0710_stats_sysfs_add(dev);
+	if (err < 0)
+		printk(KERN_WARNING "%s: stats sysfs group unavailable (%d)\n",
+			dev->name, err);
+	else
+		dev->stats_sysfs = true;
+
 	dev->kthread_hdmi = kthread_run(sc0710_thread_hdmi_function, dev, "sc0710 hdmi");
 	if (IS_ERR(dev->kthread_hdmi)) {
 		printk(KERN_ERR "%s() Failed to create "
@@ -987,6 +1620,14 @@ static int sc0710_initdev(struct pci_dev *pci_dev,
 	} else
 		dprintk(1, "%s() Created the DMA thread\n", __func__);
 
+	dev->kthread_audio = kthread_run(sc0710_thread_audio_function, dev, "sc0710 audio");
+	if (IS_ERR(dev->kthread_audio)) {
+		printk(KERN_ERR "%s() Failed to create "
+			"audio kernel thread (%ld)\n", __func__, PTR_ERR(dev->kthread_audio));
+		dev->kthread_audio = NULL;
+	} else
+		dprintk(1, "%s() Created the audio thread\n", __func__);
+
 	if (dev->board == SC0710_BOARD_ELGATEO_4KP60_MK2) {
 		err = device_create_bin_file(&pci_dev->dev, &bin_attr_hdr_tonemap);
 		if (err < 0)
@@ -1007,6 +1648,9 @@ static int sc0710_initdev(struct pci_dev *pci_dev,
 	return 0;
 
 fail_dev:
+	if (dev->dq_wq)
+		destroy_workqueue(dev->dq_wq);
+	sc0710_px_pool_free(dev);
 	sc0710_dev_unregister(dev);
 fail_disable:
 	pci_disable_device(pci_dev);
@@ -1026,6 +1670,11 @@ static void sc0710_finidev(struct pci_dev *pci_dev)
 	struct sc0710_dev *dev = pci_get_drvdata(pci_dev);
 	int i;
 
+	if (dev->stats_sysfs) {
+		sc0710_stats_sysfs_remove(dev);
+		dev->stats_sysfs = false;
+	}
+
 	if (dev->board == SC0710_BOARD_ELGATEO_4KP60_MK2) {
 		device_remove_bin_file(&pci_dev->dev, &bin_attr_hdr_tonemap);
 		device_remove_file(&pci_dev->dev, &dev_attr_color_deep);
@@ -1036,6 +1685,11 @@ static void sc0710_finidev(struct pci_dev *pci_dev)
 		dev->kthread_dma = NULL;
 	}
 
+	if (dev->kthread_audio) {
+		kthread_stop(dev->kthread_audio);
+		dev->kthread_audio = NULL;
+	}
+
 	if (dev->kthread_hdmi) {
 		kthread_stop(dev->kthread_hdmi);
 		dev->kthread_hdmi = NULL;
@@ -1107,8 +1761,17 @@ static void sc0710_finidev(struct pci_dev *pci_dev)
 
 	pci_disable_device(pci_dev);
 
+	/* The sampler reads the channels' counters, freed just below. */
+	sc0710_stats_stop(dev);
 	sc0710_dev_unregister(dev);
 
+	/* Idle: every channel stop flushed its handoff queue. */
+	if (dev->dq_wq) {
+		destroy_workqueue(dev->dq_wq);
+		dev->dq_wq = NULL;
+	}
+	sc0710_px_pool_free(dev);
+
 	/* Free frame staging buffers if allocated */
 	if (dev->frame_staging_buf) {
 		vfree(dev->frame_staging_buf);
@@ -30,6 +30,8 @@
 #include <linux/module.h>
 #include <linux/moduleparam.h>
 #include <linux/init.h>
+#include <linux/gfp.h>
+#include <linux/dma-mapping.h>
 
 #include "sc0710.h"
 
@@ -39,7 +41,8 @@
         } while (0)
 
 /* Copy the chain contents into a target buffer, don't overflow.
- * Return numbers of bytes, or < 0 if overflow detected.
+ * Return numbers of bytes, or < 0 if overflow detected. Every byte read
+ * out of the scratch allocations is charged to ch->scratch_bytes_read.
  */
 int sc0710_dma_chain_dq_to_ptr(struct sc0710_dma_channel *ch, struct sc0710_dma_descriptor_chain *chain, u8 *dst, int dstlen)
 {
@@ -52,14 +55,74 @@ int sc0710_dma_chain_dq_to_ptr(struct sc0710_dma_channel *ch, struct sc0710_dma_
 			memcpy(dst + len, dca->buf_cpu, dca->buf_size);
 			len += dca->buf_size;
 		} else {
+			atomic64_add(len, &ch->scratch_bytes_read);
 			return -EOVERFLOW;
 		}
 		dca++;
 	}
 
+	atomic64_add(len, &ch->scratch_bytes_read);
 	return len;
 }
 
+/* Copy len bytes starting at byte offset off of the chain's frame into
+ * dst, across allocation boundaries. Returns the bytes copied, or < 0 if
+ * the range runs past the chain. Charged to ch->scratch_bytes_read like a
+ * whole-chain dequeue.
+ */
+int sc0710_dma_chain_copy_range(struct sc0710_dma_channel *ch, struct sc0710_dma_descriptor_chain *chain,
+	u32 off, u8 *dst, u32 len)
+{
+	struct sc0710_dma_descriptor_chain_allocation *dca = &chain->allocations[0];
+	u32 done = 0;
+	u32 i;
+
+	for (i = 0; i < chain->numAllocations && done < len; i++, dca++) {
+		u32 n;
+
+		if (off >= dca->buf_size) {
+			off -= dca->buf_size;
+			continue;
+		}
+		n = min(dca->buf_size - off, len - done);
+		memcpy(dst + done, (u8 *)dca->buf_cpu + off, n);
+		done += n;
+		off = 0;
+	}
+
+	atomic64_add(done, &ch->scratch_bytes_read);
+	return done == len ? (int)done : -EOVERFLOW;
+}
+
+/* Streaming scratch: make a completed lap's payload visible to the CPU
+ * before anything reads it out of the allocations. No-op on coherent
+ * chains. */
+void sc0710_dma_chain_sync_for_cpu(struct sc0710_dma_channel *ch, struct sc0710_dma_descriptor_chain *chain)
+{
+	u32 i;
+
+	if (!chain->streaming)
+		return;
+
+	for (i = 0; i < chain->numAllocations; i++)
+		dma_sync_single_for_cpu(&ch->dev->pci->dev, chain->allocations[i].buf_dma,
+			chain->allocations[i].buf_size, DMA_FROM_DEVICE);
+}
+
+/* Streaming scratch: hand the allocations back to the device once the lap
+ * has been read, ahead of its next write into them. */
+void sc0710_dma_chain_sync_for_device(struct sc0710_dma_channel *ch, struct sc0710_dma_descriptor_chain *chain)
+{
+	u32 i;
+
+	if (!chain->streaming)
+		return;
+
+	for (i = 0; i < chain->numAllocations; i++)
+		dma_sync_single_for_device(&ch->dev->pci->dev, chain->allocations[i].buf_dma,
+			chain->allocations[i].buf_size, DMA_FROM_DEVICE);
+}
+
 void sc0710_dma_chain_dump(struct sc0710_dma_channel *ch, struct sc0710_dma_descriptor_chain *chain, int nr)
 {
 	struct sc0710_dma_descriptor_chain_allocation *dca = &chain->allocations[0];
@@ -104,26 +167,56 @@ void sc0710_dma_chain_free(struct sc0710_dma_channel *ch, int nr)
 
 	chain->enabled = 0;
 
-	for (i = 0; i < chain->numAllocations; i++) {
-		if (dca->buf_cpu) {
-			dma_free_coherent(&dev->pci->dev, dca->buf_size, dca->buf_cpu, dca->buf_dma);
+	for (i = 0; i < chain->numBacked; i++) {
+		if (dca->buf_cpu && dca->pooled) {
+			/* Owned by the pool: chains_free rewinds it. */
+			dca->buf_cpu = NULL;
+			dca->buf_dma = 0;
+			dca->pooled = false;
+		} else if (dca->buf_cpu) {
+			if (chain->streaming) {
+				dma_unmap_single(&dev->pci->dev, dca->buf_dma,
+					dca->alloc_size, DMA_FROM_DEVICE);
+				free_pages_exact(dca->buf_cpu, dca->alloc_size);
+			} else {
+				dma_free_coherent(&dev->pci->dev, dca->alloc_size, dca->buf_cpu, dca->buf_dma);
+			}
 			dca->buf_cpu = NULL;
 			dca->buf_dma = 0;
 		}
 		dca++;
 	}
 	chain->numAllocations = 0;
+	chain->numBacked = 0;
+	chain->streaming = false;
 }
 
-int sc0710_dma_chain_alloc(struct sc0710_dma_channel *ch, int nr, int total_transfer_size)
+/* Streaming scratch backend: zeroed cacheable pages, mapped for device
+ * writes. GFP_DMA32 keeps them under the card's 32-bit DMA mask, so the
+ * mapping never needs a bounce buffer (a 4 MiB segment would not fit one). */
+static int sc0710_dma_alloc_streaming(struct sc0710_dev *dev,
+	struct sc0710_dma_descriptor_chain_allocation *dca)
 {
-	struct sc0710_dev *dev = ch->dev;
-	struct sc0710_dma_descriptor_chain *chain = &ch->chains[nr];
-	struct sc0710_dma_descriptor_chain_allocation *dca = &chain->allocations[0];
-	int rem = total_transfer_size;
-	int size;
-	int segsize = 4 * 1048576;
+	void *buf;
+
+	buf = alloc_pages_exact(dca->buf_size, GFP_KERNEL | GFP_DMA32 | __GFP_ZERO);
+	if (!buf)
+		return -ENOMEM;
+
+	dca->buf_dma = dma_map_single(&dev->pci->dev, buf, dca->buf_size, DMA_FROM_DEVICE);
+	if (dma_mapping_error(&dev->pci->dev, dca->buf_dma)) {
+		free_pages_exact(buf, dca->buf_size);
+		dca->buf_dma = 0;
+		return -ENOMEM;
+	}
+	dca->buf_cpu = buf;
 
+	return 0;
+}
+
+/* Largest allocation a chain of total_transfer_size bytes is cut into. */
+u32 sc0710_dma_chain_segsize(struct sc0710_dma_channel *ch, int total_transfer_size)
+{
 	/* Zero-copy: split video chains finer. More (smaller) descriptors per
 	 * chain keep a rewritten chain's ring slots beyond the device's
 	 * descriptor read-ahead, and shrink the contiguous pieces a client
@@ -131,12 +224,36 @@ int sc0710_dma_chain_alloc(struct sc0710_dma_channel *ch, int nr, int total_tran
 	if (zero_copy && zc_split && ch->mediatype == CHTYPE_VIDEO) {
 		u32 split = min_t(u32, zc_split, SC0710_MAX_CHAIN_DESCRIPTORS);
 
-		segsize = ALIGN(DIV_ROUND_UP(total_transfer_size, split), 4096);
+		return ALIGN(DIV_ROUND_UP(total_transfer_size, split), 4096);
 	}
 
+	return 4 * 1048576;
+}
+
+/* Descriptors a chain of total_transfer_size bytes is cut into. */
+u32 sc0710_dma_chain_segments(struct sc0710_dma_channel *ch, int total_transfer_size)
+{
+	if (total_transfer_size <= 0)
+		return 1;
+	return DIV_ROUND_UP(total_transfer_size,
+		sc0710_dma_chain_segsize(ch, total_transfer_size));
+}
+
+int sc0710_dma_chain_alloc(struct sc0710_dma_channel *ch, int nr, int total_transfer_size)
+{
+	struct sc0710_dev *dev = ch->dev;
+	struct sc0710_dma_descriptor_chain *chain = &ch->chains[nr];
+	struct sc0710_dma_descriptor_chain_allocation *dca = &chain->allocations[0];
+	int rem = total_transfer_size;
+	int size;
+	int segsize = sc0710_dma_chain_segsize(ch, total_transfer_size);
+
 	chain->enabled = 1;
 	chain->total_transfer_size = total_transfer_size;
 	chain->numAllocations = 0;
+	/* Audio stays coherent: its samples are read straight out of the
+	 * allocation by the ALSA delivery path. */
+	chain->streaming = stream_scratch && ch->mediatype == CHTYPE_VIDEO;
 
 	/* First thing we should do is determine all of the allocations
 	 * for the total transfer_size, build the segment sizes and alloc
@@ -155,17 +272,62 @@ int sc0710_dma_chain_alloc(struct sc0710_dma_channel *ch, int nr, int total_tran
 
 		dca->enabled = 1;
 		dca->buf_size = size;
+		dca->alloc_size = size;
+		dca->pooled = false;
 		/* GFP_KERNEL: every caller (probe, STREAMON, the kthreads) is
 		 * sleepable process context. */
-		dca->buf_cpu = dma_alloc_coherent(&dev->pci->dev, dca->buf_size, &dca->buf_dma, GFP_KERNEL);
-		if (dca->buf_cpu == 0)
-			return -ENOMEM;
+		if (chain->streaming) {
+			if (sc0710_dma_alloc_streaming(dev, dca) < 0)
+				return -ENOMEM;
+		} else if (sc0710_dma_pool_carve(ch, dca) == 0) {
+			/* Zeroed once, when the pool was reserved. */
+		} else {
+			dca->buf_cpu = dma_alloc_coherent(&dev->pci->dev, dca->buf_size, &dca->buf_dma, GFP_KERNEL);
+			if (dca->buf_cpu == 0)
+				return -ENOMEM;
 
-		memset(dca->buf_cpu, 0, dca->buf_size);
+			memset(dca->buf_cpu, 0, dca->buf_size);
+		}
 
 		chain->numAllocations++;
+		chain->numBacked++;
 		dca++;
 		rem -= size;
 	}
 	return 0; /* Success */
 }
+
+/* Re-describe chain nr for a frame of total_transfer_size bytes over the
+ * allocations it already holds: the cut sc0710_dma_chain_alloc() would
+ * make, each piece inside the allocation at its index. No allocation, no
+ * zeroing. -ENOSPC, chain untouched, if a piece doesn't fit. */
+int sc0710_dma_chain_recut(struct sc0710_dma_channel *ch, int nr, int total_transfer_size)
+{
+	struct sc0710_dma_descriptor_chain *chain = &ch->chains[nr];
+	u32 segsize, n, rem, i;
+
+	if (total_transfer_size <= 0)
+		return -EINVAL;
+
+	segsize = sc0710_dma_chain_segsize(ch, total_transfer_size);
+	n = sc0710_dma_chain_segments(ch, total_transfer_size);
+	if (n > chain->numBacked)
+		return -ENOSPC;
+
+	rem = total_transfer_size;
+	for (i = 0; i < n; i++) {
+		if (min(rem, segsize) > chain->allocations[i].alloc_size)
+			return -ENOSPC;
+		rem -= min(rem, segsize);
+	}
+
+	rem = total_transfer_size;
+	for (i = 0; i < n; i++) {
+		chain->allocations[i].buf_size = min(rem, segsize);
+		rem -= chain->allocations[i].buf_size;
+	}
+	chain->numAllocations = n;
+	chain->total_transfer_size = total_transfer_size;
+
+	return 0;
+}
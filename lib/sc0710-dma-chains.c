@@ -58,15 +58,23 @@ void sc0710_dma_chains_free(struct sc0710_dma_channel *ch)
 		ch->pt_dma = 0;
 	}
 
-	for (i = 0; i < ch->numDescriptorChains; i++) {
+	/* Chains past the current depth may still hold allocations. */
+	for (i = 0; i < ch->maxDescriptorChains; i++) {
 		sc0710_dma_chain_free(ch, i);
 	}
+
+	ch->pool.next_seg = 0;
+	ch->pool.next_off = 0;
 }
 
 int sc0710_dma_chains_alloc(struct sc0710_dma_channel *ch, int total_transfer_size)
 {
 	int i, ret;
 
+	/* Every chain was freed first: the whole pool is ours. */
+	ch->pool.next_seg = 0;
+	ch->pool.next_off = 0;
+
 	for (i = 0; i < ch->numDescriptorChains; i++) {
 		ret = sc0710_dma_chain_alloc(ch, i, total_transfer_size);
 		if (ret < 0) {
@@ -81,3 +89,102 @@ int sc0710_dma_chains_alloc(struct sc0710_dma_channel *ch, int total_transfer_si
 	return 0;
 }
 
+/* Re-describe the ring at depth chains for a frame of total_transfer_size
+ * bytes, keeping every allocation it holds: chains with allocations are
+ * re-cut over them, chains without any (a deeper ring) are allocated.
+ * On failure the ring is left half-described and the caller must rebuild
+ * it with sc0710_dma_chains_free() and sc0710_dma_chains_alloc(). */
+int sc0710_dma_chains_recut(struct sc0710_dma_channel *ch, u32 depth, int total_transfer_size)
+{
+	int i, ret;
+
+	if (depth > ch->maxDescriptorChains)
+		return -EINVAL;
+
+	for (i = 0; i < depth; i++) {
+		if (ch->chains[i].numBacked)
+			ret = sc0710_dma_chain_recut(ch, i, total_transfer_size);
+		else
+			ret = sc0710_dma_chain_alloc(ch, i, total_transfer_size);
+		if (ret < 0)
+			return ret;
+	}
+	ch->numDescriptorChains = depth;
+
+	return 0;
+}
+
+/* Reserve nsegs coherent segments of seg_size bytes. A partial pool is
+ * kept (and reported): whatever it can't hold is allocated per build. */
+int sc0710_dma_pool_alloc(struct sc0710_dma_channel *ch, u32 nsegs, u32 seg_size)
+{
+	struct sc0710_dma_pool *pool = &ch->pool;
+	struct sc0710_dev *dev = ch->dev;
+	u32 i;
+
+	pool->seg = kcalloc(nsegs, sizeof(*pool->seg), GFP_KERNEL);
+	if (!pool->seg)
+		return -ENOMEM;
+	pool->seg_size = seg_size;
+
+	for (i = 0; i < nsegs; i++) {
+		pool->seg[i].cpu = dma_alloc_coherent(&dev->pci->dev, seg_size,
+			&pool->seg[i].dma, GFP_KERNEL);
+		if (!pool->seg[i].cpu)
+			break;
+		memset(pool->seg[i].cpu, 0, seg_size);
+	}
+	pool->nsegs = i;
+	pool->next_seg = 0;
+	pool->next_off = 0;
+
+	if (i < nsegs)
+		printk(KERN_WARNING "%s: channel %d scratch pool short, %u of %u MiB reserved\n",
+			dev->name, ch->nr, (i * seg_size) >> 20, (nsegs * seg_size) >> 20);
+	else
+		printk(KERN_INFO "%s: channel %d scratch pool, %u MiB reserved\n",
+			dev->name, ch->nr, (nsegs * seg_size) >> 20);
+
+	return i ? 0 : -ENOMEM;
+}
+
+/* After every chain carved from the pool has been freed. */
+void sc0710_dma_pool_free(struct sc0710_dma_channel *ch)
+{
+	struct sc0710_dma_pool *pool = &ch->pool;
+	u32 i;
+
+	for (i = 0; i < pool->nsegs; i++)
+		dma_free_coherent(&ch->dev->pci->dev, pool->seg_size,
+			pool->seg[i].cpu, pool->seg[i].dma);
+	kfree(pool->seg);
+	pool->seg = NULL;
+	pool->nsegs = 0;
+}
+
+/* Back dca (buf_size already set) with the next free piece of the pool;
+ * pieces never straddle a segment. -ENOMEM once the pool is used up. */
+int sc0710_dma_pool_carve(struct sc0710_dma_channel *ch,
+	struct sc0710_dma_descriptor_chain_allocation *dca)
+{
+	struct sc0710_dma_pool *pool = &ch->pool;
+	u32 size = PAGE_ALIGN(dca->buf_size);
+
+	if (size > pool->seg_size)
+		return -ENOMEM;
+
+	for (; pool->next_seg < pool->nsegs; pool->next_seg++, pool->next_off = 0) {
+		struct sc0710_dma_pool_seg *seg = &pool->seg[pool->next_seg];
+
+		if (pool->next_off + size > pool->seg_size)
+			continue;
+
+		dca->buf_cpu = (u64 *)((u8 *)seg->cpu + pool->next_off);
+		dca->buf_dma = seg->dma + pool->next_off;
+		dca->pooled = true;
+		pool->next_off += size;
+		return 0;
+	}
+
+	return -ENOMEM;
+}
@@ -32,6 +32,7 @@
 #include <linux/vmalloc.h>
 
 #include "sc0710.h"
+#include "sc0710-trace.h"
 
 #define dprintk(level, fmt, arg...)\
         do { if (sc0710_debug_mode >= level)\
@@ -39,7 +40,27 @@
         } while (0)
 
 #define DMA_AUDIO_TRANSFER_SIZE 0x4000
-#define DMA_TRANSFER_CHAINS     4
+#define DMA_TRANSFER_CHAINS     SC0710_MIN_CHANNEL_DESCRIPTOR_CHAINS
+
+/* Auto ring depth (ring_depth=0): frames enough to ride out this much
+ * service delay, within this much scratch memory. */
+#define DMA_RING_TARGET_MS      50
+#define DMA_RING_BUDGET_BYTES   (96 * 1048576)
+
+/* scratch_pool=1 reserves for the largest frame the card produces (UHD
+ * BGR24) at the ring's minimum depth, or the auto depth's budget. */
+#define DMA_POOL_SEG_BYTES      (4 * 1048576)
+#define DMA_POOL_MAX_FRAME      (3840 * 2160 * 3)
+
+/* Zero-copy recovery: clean sentinel laps before a re-armed channel is
+ * trusted again (about five minutes at 60 Hz), and trips this close
+ * together that count as a run - the third disables zero-copy. */
+#define DMA_ZC_PROBATION_LAPS   18000
+#define DMA_ZC_TRIP_WINDOW_NS   (3600ULL * NSEC_PER_SEC)
+#define DMA_ZC_MAX_TRIPS        3
+
+/* Descriptor length field: 28 bits. */
+#define DMA_DESC_MAX_BYTES      0x0FFFFFFF
 
 bool sc0710_guess_dims_from_framesize(u32 frame_bytes, u32 *w, u32 *h)
 {
@@ -76,6 +97,38 @@ bool sc0710_guess_dims_from_framesize(u32 frame_bytes, u32 *w, u32 *h)
 	return false;
 }
 
+/* One frame's pixel pass, cut into row stripes by sc0710_px_run(). Each
+ * stripe callback reads the shared inputs and writes only its own rows of
+ * @dst and its own slot of the per-stripe results.
+ */
+struct sc0710_px_job {
+	struct sc0710_dma_channel *ch;
+	struct sc0710_dma_descriptor_chain *chain;
+	const u8 *src;
+	u8 *dst;
+	u32 width;
+	u32 height;
+	bool tonemap;
+	bool failed;	/* A stripe's chain read came up short */
+
+	/* Tear scan */
+	u32 step_x;
+	u64 tear_sum[SC0710_PX_MAX_STRIPES];
+	u32 tear_max[SC0710_PX_MAX_STRIPES];
+	int tear_line[SC0710_PX_MAX_STRIPES];
+};
+
+static void sc0710_px_tonemap_rows(struct sc0710_dev *dev, u8 *buf,
+	u32 width, u32 y0, u32 y1)
+{
+	u8 *rows = buf + y0 * width * sc0710_bpp(dev);
+
+	if (dev->pixfmt->rgb)
+		sc0710_bgr24_sw_tonemap(rows, width, y1 - y0);
+	else
+		sc0710_yuyv8_sw_tonemap(rows, width, y1 - y0);
+}
+
 /* Weave two vertically-stacked fields into a proper interlaced frame.
  * The hardware delivers interlaced content as Field 1 (top) followed by
  * Field 2 (bottom) in a single DMA buffer.  This function interleaves
@@ -83,50 +136,105 @@ bool sc0710_guess_dims_from_framesize(u32 frame_bytes, u32 *w, u32 *h)
  * lines come from Field 2, producing a standard V4L2_FIELD_INTERLACED frame.
  *
  * @src and @dst must not overlap.  @height is the full frame height
- * (must be even).
+ * (must be even). Stripe callback over output lines [y0, y1).
  */
-static void sc0710_weave_fields(const u8 *src, u8 *dst, u32 width, u32 height)
+static void sc0710_weave_fields(void *arg, u32 y0, u32 y1, int stripe)
 {
-	u32 stride = width * 2; /* YUYV: 2 bytes per pixel */
-	u32 field_height = height / 2;
-	const u8 *field1 = src;
-	const u8 *field2 = src + field_height * stride;
+	struct sc0710_px_job *job = arg;
+	u32 stride = job->width * 2; /* YUYV: 2 bytes per pixel */
+	u32 field_height = job->height / 2;
 	u32 y;
 
-	for (y = 0; y < field_height; y++) {
-		memcpy(dst + (y * 2)     * stride, field1 + y * stride, stride);
-		memcpy(dst + (y * 2 + 1) * stride, field2 + y * stride, stride);
+	for (y = y0; y < y1; y++) {
+		u32 src_line = (y & 1) ? field_height + y / 2 : y / 2;
+
+		memcpy(job->dst + y * stride, job->src + src_line * stride, stride);
 	}
 }
 
-/* Detect a likely persistent horizontal tear seam.
- * This runs only in a short post-resync validation window.
+/* Single-pass variant of a chain gather followed by sc0710_weave_fields()
+ * and the host tonemap: each source line is read straight out of the
+ * scratch segments to its woven position in @dst and, with @tonemap set,
+ * tonemapped there while still cache-hot. One read of the ring and one
+ * write of @dst replace the gather, weave and tonemap passes. Stripe
+ * callback over output lines [y0, y1); sets job->failed if the chain
+ * could not supply them.
  */
-static bool sc0710_detect_horizontal_tear(const u8 *buf, u32 width, u32 height, int *tear_line)
+static void sc0710_weave_fields_from_chain(void *arg, u32 y0, u32 y1, int stripe)
 {
-	u32 stride;
-	u32 step_x;
-	u64 avg_score = 0;
-	u32 max_score = 0;
-	int max_line = -1;
+	struct sc0710_px_job *job = arg;
+	struct sc0710_dev *dev = job->ch->dev;
+	u32 stride = job->width * sc0710_bpp(dev);
+	u32 field_height = job->height / 2;
 	u32 y;
 
-	if (!buf || width < 320 || height < 120)
-		return false;
+	for (y = y0; y < y1; y++) {
+		/* Output line y: even lines from field 1, odd from field 2. */
+		u32 src_line = (y & 1) ? field_height + y / 2 : y / 2;
+		u8 *line = job->dst + y * stride;
 
-	stride = width * 2; /* YUYV */
-	step_x = width / 128;
-	if (step_x < 8)
-		step_x = 8;
+		if (sc0710_dma_chain_copy_range(job->ch, job->chain,
+						src_line * stride, line, stride) < 0) {
+			WRITE_ONCE(job->failed, true);
+			return;
+		}
+
+		if (job->tonemap)
+			sc0710_px_tonemap_rows(dev, job->dst, job->width, y, y + 1);
+	}
+}
+
+/* Host tonemap in place over rows [y0, y1) of a gathered frame. */
+static void sc0710_px_tonemap(void *arg, u32 y0, u32 y1, int stripe)
+{
+	struct sc0710_px_job *job = arg;
 
-	for (y = 0; y + 1 < height; y++) {
-		const u8 *row0 = buf + (y * stride);
+	sc0710_px_tonemap_rows(job->ch->dev, job->dst, job->width, y0, y1);
+}
+
+/* Progressive gather + host tonemap: rows [y0, y1) out of the scratch
+ * ring into @dst a few at a time, each batch tonemapped while still
+ * cache-hot. */
+#define SC0710_PX_GATHER_ROWS 8
+
+static void sc0710_px_gather_tonemap(void *arg, u32 y0, u32 y1, int stripe)
+{
+	struct sc0710_px_job *job = arg;
+	struct sc0710_dev *dev = job->ch->dev;
+	u32 stride = job->width * sc0710_bpp(dev);
+	u32 y, n;
+
+	for (y = y0; y < y1; y += n) {
+		n = min_t(u32, SC0710_PX_GATHER_ROWS, y1 - y);
+		if (sc0710_dma_chain_copy_range(job->ch, job->chain, y * stride,
+						job->dst + y * stride,
+						n * stride) < 0) {
+			WRITE_ONCE(job->failed, true);
+			return;
+		}
+		sc0710_px_tonemap_rows(dev, job->dst, job->width, y, y + n);
+	}
+}
+
+/* Tear scan over line pairs (y, y + 1) for y in [y0, y1): mean luma step
+ * per pair, summed, plus the strongest pair (first one on a tie). */
+static void sc0710_tear_scan_lines(void *arg, u32 y0, u32 y1, int stripe)
+{
+	struct sc0710_px_job *job = arg;
+	u32 stride = job->width * 2; /* YUYV */
+	u64 sum = 0;
+	u32 max_score = 0;
+	int max_line = -1;
+	u32 y;
+
+	for (y = y0; y < y1; y++) {
+		const u8 *row0 = job->src + (y * stride);
 		const u8 *row1 = row0 + stride;
 		u32 x;
 		u32 score = 0;
 		u32 samples = 0;
 
-		for (x = 0; x < width; x += step_x) {
+		for (x = 0; x < job->width; x += job->step_x) {
 			u32 off = x * 2; /* Y component per pixel */
 			score += abs((int)row1[off] - (int)row0[off]);
 			samples++;
@@ -134,13 +242,58 @@ static bool sc0710_detect_horizontal_tear(const u8 *buf, u32 width, u32 height,
 		if (samples)
 			score /= samples;
 
-		avg_score += score;
+		sum += score;
 		if (score > max_score) {
 			max_score = score;
 			max_line = (int)y;
 		}
 	}
 
+	job->tear_sum[stripe] = sum;
+	job->tear_max[stripe] = max_score;
+	job->tear_line[stripe] = max_line;
+}
+
+/* Detect a likely persistent horizontal tear seam.
+ * This runs only in a short post-resync validation window.
+ */
+static bool sc0710_detect_horizontal_tear(struct sc0710_dma_channel *ch,
+	const u8 *buf, u32 width, u32 height, int *tear_line)
+{
+	struct sc0710_px_job job = {
+		.ch = ch,
+		.src = buf,
+		.width = width,
+		.height = height,
+	};
+	u64 avg_score = 0;
+	u32 max_score = 0;
+	int max_line = -1;
+	int i;
+
+	if (!buf || width < 320 || height < 120)
+		return false;
+
+	job.step_x = width / 128;
+	if (job.step_x < 8)
+		job.step_x = 8;
+
+	/* Inline, not through the pixel pool: admission runs this under
+	 * ch->lock, and the pool's dispatch lock can be held for a whole
+	 * tonemap pass by the delivery worker. ~128 samples a line is
+	 * cheap enough for the few frames of a validation window. */
+	sc0710_tear_scan_lines(&job, 0, height - 1, 0);
+
+	/* Stripes are in line order: a strict compare keeps the first
+	 * strongest line, as a single top-to-bottom scan would. */
+	for (i = 0; i < SC0710_PX_MAX_STRIPES; i++) {
+		avg_score += job.tear_sum[i];
+		if (job.tear_max[i] > max_score) {
+			max_score = job.tear_max[i];
+			max_line = job.tear_line[i];
+		}
+	}
+
 	if (height > 1)
 		avg_score /= (height - 1);
 
@@ -280,45 +433,30 @@ static bool sc0710_detect_horizontal_tear(const u8 *buf, u32 width, u32 height,
  *    to perform transfers.
  */
 
-/* Copy the contains of the video chain into a video4linux buffer.
- * Return < 0 on error
- * Return number of buffers we copyinto from dma into user buffers.
- * 
+/* Decide whether a completed video chain is delivered at all. Runs in the
+ * service loop under ch->lock, ahead of any copy, so post-restart skips
+ * and drops never cost a snapshot.
+ *
  * @cached_framesize: Frame size cached at service start to prevent mid-operation changes.
  *                    This ensures consistent behavior even if dev->fmt changes during processing.
  */
-static void sc0710_dma_dequeue_video(struct sc0710_dma_channel *ch,
+static bool sc0710_dma_video_admit(struct sc0710_dma_channel *ch,
 	struct sc0710_dma_descriptor_chain *chain,
 	u32 cached_framesize,
-	u32 cached_width,
-	u32 cached_height,
 	u32 cached_interlaced)
 {
 	struct sc0710_dev *dev = ch->dev;
-	struct sc0710_client *client;
-	unsigned long flags;
-	u32 source_framesize = cached_framesize;
-	u32 source_w = cached_width, source_h = cached_height;
-	int frame_gathered = 0;
-	int delivered = 0;
-	int stale_clients = 0;
-	const u8 *woven_frame = NULL;
-	u8 *tm_frame = NULL;
-	/* Host tonemap on both YUYV and BGR24 (preview LUT; no gamut convert). */
-	int want_tm = sc0710_want_sw_tonemap(dev);
-	u32 streak_required = dma_resync_tear_streak_required ?
-		dma_resync_tear_streak_required : 1;
 
 	if (cached_framesize == 0) {
 		dprintk(1, "%s() no format detected, skipping\n", __func__);
-		return;
+		return false;
 	}
 
 	if (ch->skip_next_frames > 0) {
 		ch->skip_next_frames--;
 		dprintk(1, "%s() post-restart skip (%u remaining)\n",
 			__func__, ch->skip_next_frames);
-		return;
+		return false;
 	}
 
 	/* Format negotiation refuses formats the field weave can't produce,
@@ -327,7 +465,7 @@ static void sc0710_dma_dequeue_video(struct sc0710_dma_channel *ch,
 	if (cached_interlaced && !dev->pixfmt->weave_ok) {
 		printk_ratelimited(KERN_WARNING "%s: interlaced signal with a capture format the field weave does not support, dropping frames\n",
 			dev->name);
-		return;
+		return false;
 	}
 
 	/* During resolution transitions the detected format (cached_framesize)
@@ -340,15 +478,290 @@ static void sc0710_dma_dequeue_video(struct sc0710_dma_channel *ch,
 	    cached_framesize != (u32)chain->total_transfer_size) {
 		dprintk(1, "%s() frame size mismatch (%u vs DMA %d) - dropping\n",
 			__func__, cached_framesize, chain->total_transfer_size);
+		return false;
+	}
+
+	return true;
+}
+
+/* Interlaced frames from the chain are woven straight into one client's
+ * next buffer rather than into the weave staging buffer, saving that
+ * client a full-frame copy (the others copy from it as they would from
+ * staging). Takes the first streaming client locked to the source size
+ * with a big enough buffer queued, and removes that buffer from its
+ * queue: the caller delivers it or puts it back at the head. Caller holds
+ * ch->lock, which sc0710_stop_streaming() waits out before releasing a
+ * client's buffers. */
+static struct sc0710_buffer *sc0710_dma_take_weave_target(struct sc0710_dma_channel *ch,
+	u32 width, u32 height, u32 framesize, struct sc0710_client **owner)
+{
+	struct sc0710_client *client;
+	struct sc0710_buffer *buf = NULL;
+	unsigned long flags, buf_flags;
+
+	spin_lock_irqsave(&ch->client_list_lock, flags);
+	list_for_each_entry(client, &ch->client_list, list) {
+		if (!client->streaming ||
+		    (client->stream_width && client->stream_height &&
+		     (client->stream_width != width ||
+		      client->stream_height != height)))
+			continue;
+
+		spin_lock_irqsave(&client->buffer_lock, buf_flags);
+		if (!list_empty(&client->buffer_list)) {
+			buf = list_first_entry(&client->buffer_list,
+				struct sc0710_buffer, list);
+			if (buf->zc_unmapped) {
+				sc0710_dma_zc_unmapped_done(ch, buf);
+				buf = NULL;
+			} else if (vb2_plane_size(&buf->vb.vb2_buf, 0) >= framesize) {
+				list_del(&buf->list);
+				*owner = client;
+			} else {
+				buf = NULL;
+			}
+		}
+		spin_unlock_irqrestore(&client->buffer_lock, buf_flags);
+		if (buf)
+			break;
+	}
+	spin_unlock_irqrestore(&ch->client_list_lock, flags);
+
+	return buf;
+}
+
+/* An imported buffer with no kernel mapping (zc_unmapped) can only be
+ * filled by the DMA. Left at the head of its queue it would stall every
+ * copy delivery, and the client, behind it: a copy path that meets one
+ * returns it as an error instead, one per frame, and counts it. Caller
+ * holds the client's buffer_lock. */
+void sc0710_dma_zc_unmapped_done(struct sc0710_dma_channel *ch,
+	struct sc0710_buffer *buf)
+{
+	list_del(&buf->list);
+	atomic64_inc(&ch->zc_import_errors);
+	printk_ratelimited(KERN_WARNING "%s: zero-copy: imported buffer %u has no kernel mapping for a copied frame, returning it as an error\n",
+		ch->dev->name, buf->vb.vb2_buf.index);
+	vb2_buffer_done(&buf->vb.vb2_buf, VB2_BUF_STATE_ERROR);
+}
+
+/* Per-buffer (and, for imported buffers, per-channel) zero-copy split. */
+static void sc0710_dma_zc_account(struct sc0710_dma_channel *ch,
+	struct sc0710_buffer *buf, bool direct)
+{
+	bool imported = buf->vb.vb2_buf.memory == VB2_MEMORY_DMABUF;
+
+	if (!zero_copy)
 		return;
+
+	if (direct) {
+		buf->zc_direct++;
+		if (imported)
+			ch->zc_import_direct++;
+	} else {
+		buf->zc_copied++;
+		if (imported)
+			ch->zc_import_copied++;
+	}
+}
+
+static void sc0710_dma_requeue_head(struct sc0710_client *client,
+	struct sc0710_buffer *buf)
+{
+	unsigned long flags;
+
+	spin_lock_irqsave(&client->buffer_lock, flags);
+	list_add(&buf->list, &client->buffer_list);
+	spin_unlock_irqrestore(&client->buffer_lock, flags);
+}
+
+/* Stamp a filled buffer (payload already set, off its queue) with the
+ * frame's metadata and hand it to vb2. Caller holds client_list_lock. */
+static void sc0710_dma_buffer_finish(struct sc0710_dma_channel *ch,
+	struct sc0710_client *client, struct sc0710_buffer *vb_buf,
+	u64 ts_ns, u32 sequence, u32 interlaced, u64 t_start)
+{
+	u64 t_done;
+
+	vb_buf->vb.vb2_buf.timestamp = ts_ns ? ts_ns : ktime_get_ns();
+	vb_buf->vb.sequence = sequence;
+	vb_buf->vb.field = interlaced ?
+		V4L2_FIELD_INTERLACED : V4L2_FIELD_NONE;
+
+	t_done = ktime_get_ns();
+	vb_buf->done_ns = t_done;
+	sc0710_lat_record(&ch->lat_deliver, t_done - t_start);
+	trace_sc0710_buffer_done(ch->dev->nr, ch->nr, client,
+		vb_buf->vb.vb2_buf.index, vb_buf->vb.sequence,
+		vb_buf->vb.vb2_buf.timestamp,
+		vb2_get_plane_payload(&vb_buf->vb.vb2_buf, 0), false);
+
+	sc0710_dma_zc_account(ch, vb_buf, false);
+	vb2_buffer_done(&vb_buf->vb.vb2_buf, VB2_BUF_STATE_DONE);
+}
+
+/* Post-resync tear validation of one admitted frame: schedule a follow-up
+ * resync when a tear seam persists near the same line. Runs at admission
+ * (ch->lock held), ahead of any delivery worker, so the validation state
+ * has a single writer. @frame_buf holds the frame already when @gathered,
+ * else it is gathered from @chain here. Returns whether @frame_buf now
+ * holds the frame.
+ */
+static bool sc0710_dma_tear_validate(struct sc0710_dma_channel *ch,
+	struct sc0710_dma_descriptor_chain *chain,
+	u8 *frame_buf,
+	bool gathered,
+	u32 framesize,
+	u32 width,
+	u32 height)
+{
+	struct sc0710_dev *dev = ch->dev;
+	u32 streak_required = dma_resync_tear_streak_required ?
+		dma_resync_tear_streak_required : 1;
+	int tear_line = -1;
+	bool tear_detected = false;
+
+	if (!dev->pixfmt->tear_ok || !frame_buf) {
+		/* Validation needs a contiguous frame buffer and the
+		 * YUYV-only tear detector; disable if unavailable. */
+		ch->tear_validation_frames_left = 0;
+		ch->tear_streak_count = 0;
+		ch->tear_last_line = -1;
+		return gathered;
+	}
+
+	if (!gathered &&
+	    sc0710_dma_chain_dq_to_ptr(ch, chain, frame_buf, framesize) ==
+	    (int)framesize)
+		gathered = true;
+
+	if (gathered)
+		tear_detected = sc0710_detect_horizontal_tear(ch, frame_buf,
+			width, height, &tear_line);
+
+	if (tear_detected) {
+		bool near_same_line = (ch->tear_last_line >= 0) &&
+			(abs(ch->tear_last_line - tear_line) <= 8);
+		ch->tear_streak_count = near_same_line ?
+			(ch->tear_streak_count + 1) : 1;
+		ch->tear_last_line = tear_line;
+
+		if (ch->tear_streak_count >= streak_required) {
+			if (ch->tear_resync_retries_left > 0 && !dev->tear_resync_pending) {
+				ch->tear_resync_retries_left--;
+				dev->tear_resync_pending = 1;
+				printk(KERN_WARNING
+				       "%s: Tear seam persisted near line %d on channel %d; scheduling DMA re-resync (%u retries left)\n",
+				       dev->name, tear_line, ch->nr,
+				       ch->tear_resync_retries_left);
+			}
+			ch->tear_validation_frames_left = 0;
+		}
+	} else {
+		ch->tear_streak_count = 0;
+		ch->tear_last_line = -1;
+	}
+
+	ch->tear_validation_frames_left--;
+	return gathered;
+}
+
+/* Size the weave staging buffer for an interlaced frame. Only from
+ * admission (ch->lock held): the frame size is fixed while the channel
+ * runs, so once a queued snapshot's weave has a big enough buffer the
+ * delivery worker never sees it reallocated under it. */
+static void sc0710_dma_weave_staging(struct sc0710_dev *dev, u32 framesize)
+{
+	u8 *old = dev->weave_staging_buf;
+
+	if (old && dev->weave_staging_size >= framesize)
+		return;
+
+	dev->weave_staging_buf = vzalloc(framesize);
+	if (dev->weave_staging_buf) {
+		dev->weave_staging_size = framesize;
+	} else {
+		dev->weave_staging_size = 0;
+		printk_ratelimited(KERN_ERR "%s: Failed to allocate weave staging buffer (%u bytes)\n",
+			dev->name, framesize);
+	}
+	if (old)
+		vfree(old);
+}
+
+/* Copy an admitted video frame into every streaming client's next buffer.
+ *
+ * The frame comes either straight from a completed @chain (inline, under
+ * ch->lock), or from @frame: a handoff snapshot owned by the caller, which
+ * is then converted in place and no chain is touched (@chain is NULL).
+ * @ts_ns is the frame's capture timestamp, shared by every client's
+ * buffer (0 = stamp each buffer at delivery).
+ * @sequence was reserved at admission (sc0710_dma_video_sequence()).
+ *
+ * Tear validation and staging (re)allocation happen only on the inline
+ * path; a snapshot was validated and its weave buffer sized when it was
+ * admitted.
+ */
+static void sc0710_dma_dequeue_video(struct sc0710_dma_channel *ch,
+	struct sc0710_dma_descriptor_chain *chain,
+	u8 *frame,
+	u64 ts_ns,
+	u32 sequence,
+	u32 cached_framesize,
+	u32 cached_width,
+	u32 cached_height,
+	u32 cached_interlaced)
+{
+	struct sc0710_dev *dev = ch->dev;
+	struct sc0710_client *client;
+	unsigned long flags;
+	u32 source_framesize = cached_framesize;
+	u32 source_w = cached_width, source_h = cached_height;
+	int frame_gathered = frame != NULL;
+	int delivered = 0;
+	int stale_clients = 0;
+	int fanout_clients = 0;
+	u8 *frame_buf = frame;	/* Contiguous copy of the frame, once gathered */
+	const u8 *woven_frame = NULL;
+	const u8 *fanout_frame = NULL;
+	u8 *tm_frame = NULL;
+	struct sc0710_client *weave_client = NULL;
+	struct sc0710_buffer *weave_buf = NULL;
+	/* Host tonemap on both YUYV and BGR24 (preview LUT; no gamut convert). */
+	int want_tm = sc0710_want_sw_tonemap(dev);
+	u64 t_start = ktime_get_ns();
+
+	if (ts_ns && t_start > ts_ns)
+		sc0710_lat_record(&ch->lat_detect, t_start - ts_ns);
+
+	/* Multi-client fan-out: count the clients this frame would reach. With
+	 * two or more, every per-client chain copy re-reads the uncached
+	 * scratch allocations; gather once instead and copy from cached
+	 * memory. The count is a snapshot - a client queueing or dequeueing
+	 * a buffer in between only costs one extra or one wasted gather. */
+	if (fanout_gather && !frame) {
+		spin_lock_irqsave(&ch->client_list_lock, flags);
+		list_for_each_entry(client, &ch->client_list, list) {
+			if (!client->streaming)
+				continue;
+			if (client->stream_width && client->stream_height &&
+			    (client->stream_width != source_w ||
+			     client->stream_height != source_h))
+				continue;
+			if (!list_empty(&client->buffer_list))
+				fanout_clients++;
+		}
+		spin_unlock_irqrestore(&ch->client_list_lock, flags);
 	}
 
 	/* Pre-allocate staging buffer outside of spinlock context.
 	 * vzalloc/vfree are sleeping calls that must not be called
 	 * while holding spinlocks.  We size the buffer once here for
-	 * the tear-validation, interlaced weaving, and host tonemap paths.
+	 * the tear-validation, interlaced weaving, host tonemap and
+	 * multi-client fan-out paths.
 	 */
-	if ((cached_interlaced || ch->tear_validation_frames_left > 0 || want_tm) &&
+	if (!frame &&
+	    (ch->tear_validation_frames_left > 0 || want_tm || fanout_clients > 1) &&
 	    (!dev->frame_staging_buf ||
 	     dev->frame_staging_size < source_framesize)) {
 		u8 *old = dev->frame_staging_buf;
@@ -365,120 +778,105 @@ static void sc0710_dma_dequeue_video(struct sc0710_dma_channel *ch,
 			vfree(old);
 	}
 
-	if (cached_interlaced &&
-	    (!dev->weave_staging_buf ||
-	     dev->weave_staging_size < source_framesize)) {
-		u8 *old = dev->weave_staging_buf;
+	if (!frame && dev->frame_staging_buf &&
+	    dev->frame_staging_size >= source_framesize)
+		frame_buf = dev->frame_staging_buf;
 
-		dev->weave_staging_buf = vzalloc(source_framesize);
-		if (dev->weave_staging_buf) {
-			dev->weave_staging_size = source_framesize;
-		} else {
-			dev->weave_staging_size = 0;
-			printk_ratelimited(KERN_ERR "%s: Failed to allocate weave staging buffer (%u bytes)\n",
-				dev->name, source_framesize);
-		}
-		if (old)
-			vfree(old);
-	}
+	if (!frame && cached_interlaced)
+		sc0710_dma_weave_staging(dev, source_framesize);
 
 	/* Validate the first frames after resync and schedule a follow-up
 	 * resync when a persistent tear seam is detected.
 	 */
-	if (ch->tear_validation_frames_left > 0) {
-		if (dev->pixfmt->tear_ok &&
-		    dev->frame_staging_buf &&
-		    dev->frame_staging_size >= source_framesize) {
-			int gathered = sc0710_dma_chain_dq_to_ptr(ch, chain,
-				dev->frame_staging_buf, source_framesize);
-			int tear_line = -1;
-			bool tear_detected = false;
-
-			if (gathered == (int)source_framesize) {
-				frame_gathered = 1;
-				tear_detected = sc0710_detect_horizontal_tear(
-					dev->frame_staging_buf, source_w, source_h, &tear_line);
-			}
-
-			if (tear_detected) {
-				bool near_same_line = (ch->tear_last_line >= 0) &&
-					(abs(ch->tear_last_line - tear_line) <= 8);
-				ch->tear_streak_count = near_same_line ?
-					(ch->tear_streak_count + 1) : 1;
-				ch->tear_last_line = tear_line;
-
-				if (ch->tear_streak_count >= streak_required) {
-					if (ch->tear_resync_retries_left > 0 && !dev->tear_resync_pending) {
-						ch->tear_resync_retries_left--;
-						dev->tear_resync_pending = 1;
-						printk(KERN_WARNING
-						       "%s: Tear seam persisted near line %d on channel %d; scheduling DMA re-resync (%u retries left)\n",
-						       dev->name, tear_line, ch->nr,
-						       ch->tear_resync_retries_left);
-					}
-					ch->tear_validation_frames_left = 0;
-				}
-			} else {
-				ch->tear_streak_count = 0;
-				ch->tear_last_line = -1;
-			}
-
-			ch->tear_validation_frames_left--;
-		} else {
-			/* Validation needs a contiguous frame buffer and the
-			 * YUYV-only tear detector; disable if unavailable. */
-			ch->tear_validation_frames_left = 0;
-			ch->tear_streak_count = 0;
-			ch->tear_last_line = -1;
-		}
-	}
+	if (!frame && ch->tear_validation_frames_left > 0)
+		frame_gathered = sc0710_dma_tear_validate(ch, chain, frame_buf,
+			frame_gathered, source_framesize, source_w, source_h);
 
 	/* For interlaced content the hardware delivers two fields stacked
 	 * vertically (Field 1 on top, Field 2 on bottom).  Weave them into
-	 * a proper interleaved frame before delivering to clients.
+	 * a proper interleaved frame before delivering to clients. Unless
+	 * tear validation already gathered the frame, the weave (and the
+	 * host tonemap) run fused, straight out of the scratch ring.
 	 */
 	if (cached_interlaced && source_h >= 2 &&
-	    dev->frame_staging_buf && dev->frame_staging_size >= source_framesize &&
 	    dev->weave_staging_buf && dev->weave_staging_size >= source_framesize) {
-		if (!frame_gathered) {
-			int gathered = sc0710_dma_chain_dq_to_ptr(ch, chain,
-				dev->frame_staging_buf, source_framesize);
-			if (gathered == (int)source_framesize)
-				frame_gathered = 1;
-		}
+		struct sc0710_px_job job = {
+			.ch = ch,
+			.chain = chain,
+			.src = frame_buf,
+			.dst = dev->weave_staging_buf,
+			.width = source_w,
+			.height = source_h,
+			.tonemap = want_tm,
+		};
+
 		if (frame_gathered) {
-			sc0710_weave_fields(dev->frame_staging_buf,
-				dev->weave_staging_buf, source_w, source_h);
+			sc0710_px_run(dev, source_h, sc0710_weave_fields, &job);
 			woven_frame = dev->weave_staging_buf;
+		} else {
+			weave_buf = sc0710_dma_take_weave_target(ch, source_w,
+				source_h, source_framesize, &weave_client);
+			if (weave_buf)
+				job.dst = sc0710_buf_vaddr(weave_buf);
+
+			sc0710_px_run(dev, source_h,
+				sc0710_weave_fields_from_chain, &job);
+			if (!job.failed) {
+				woven_frame = job.dst;
+				if (want_tm)
+					tm_frame = job.dst;
+				if (weave_buf)
+					ch->weave_direct++;
+			} else if (weave_buf) {
+				sc0710_dma_requeue_head(weave_client, weave_buf);
+				weave_buf = NULL;
+				weave_client = NULL;
+			}
 		}
 	}
 
 	/*
 	 * Host HDR→SDR (optional): gather once into staging, tonemap in place,
 	 * then all clients read from that buffer. Works for YUYV and BGR24.
+	 * Unless the frame is already in memory, each stripe gathers its own
+	 * rows and tonemaps them while cache-hot.
 	 */
-	if (want_tm) {
-		if (!woven_frame && !frame_gathered &&
-		    dev->frame_staging_buf &&
-		    dev->frame_staging_size >= source_framesize) {
-			int gathered = sc0710_dma_chain_dq_to_ptr(ch, chain,
-				dev->frame_staging_buf, source_framesize);
-			if (gathered == (int)source_framesize)
+	if (want_tm && !tm_frame) {
+		struct sc0710_px_job job = {
+			.ch = ch,
+			.chain = chain,
+			.width = source_w,
+			.height = source_h,
+			.tonemap = true,
+		};
+
+		if (woven_frame || frame_gathered) {
+			tm_frame = woven_frame ? (u8 *)woven_frame : frame_buf;
+			job.dst = tm_frame;
+			sc0710_px_run(dev, source_h, sc0710_px_tonemap, &job);
+		} else if (frame_buf) {
+			job.dst = frame_buf;
+			sc0710_px_run(dev, source_h, sc0710_px_gather_tonemap, &job);
+			if (!job.failed) {
 				frame_gathered = 1;
-		}
-		if (woven_frame)
-			tm_frame = (u8 *)woven_frame;
-		else if (frame_gathered)
-			tm_frame = dev->frame_staging_buf;
-
-		if (tm_frame) {
-			if (dev->pixfmt->rgb)
-				sc0710_bgr24_sw_tonemap(tm_frame, source_w, source_h);
-			else
-				sc0710_yuyv8_sw_tonemap(tm_frame, source_w, source_h);
+				tm_frame = frame_buf;
+			}
 		}
 	}
 
+	/* Fan-out: reuse a frame already gathered (for validation, or the
+	 * handoff snapshot), else gather it now, so the scratch ring is read
+	 * once per frame. */
+	if ((fanout_clients > 1 || frame_gathered) &&
+	    !tm_frame && !woven_frame && frame_buf) {
+		if (!frame_gathered &&
+		    sc0710_dma_chain_dq_to_ptr(ch, chain, frame_buf,
+				source_framesize) == (int)source_framesize)
+			frame_gathered = 1;
+		if (frame_gathered)
+			fanout_frame = frame_buf;
+	}
+
 	/* Broadcast frame to all streaming clients */
 	spin_lock_irqsave(&ch->client_list_lock, flags);
 	list_for_each_entry(client, &ch->client_list, list) {
@@ -486,7 +884,8 @@ static void sc0710_dma_dequeue_video(struct sc0710_dma_channel *ch,
 		unsigned long buf_flags;
 		u8 *dst;
 		unsigned long buffer_size;
-		const u8 *src_frame = tm_frame ? tm_frame : woven_frame;
+		const u8 *src_frame = tm_frame ? tm_frame :
+			(woven_frame ? woven_frame : fanout_frame);
 
 		if (!client->streaming)
 			continue;
@@ -501,6 +900,11 @@ static void sc0710_dma_dequeue_video(struct sc0710_dma_channel *ch,
 			continue;
 		}
 
+		/* Woven in place above; delivered last, below, as the
+		 * others copy out of it. */
+		if (client == weave_client)
+			continue;
+
 		spin_lock_irqsave(&client->buffer_lock, buf_flags);
 
 		if (list_empty(&client->buffer_list)) {
@@ -509,10 +913,11 @@ static void sc0710_dma_dequeue_video(struct sc0710_dma_channel *ch,
 		}
 
 		vb_buf = list_first_entry(&client->buffer_list, struct sc0710_buffer, list);
-		dst = vb2_plane_vaddr(&vb_buf->vb.vb2_buf, 0);
+		dst = sc0710_buf_vaddr(vb_buf);
 		buffer_size = vb2_plane_size(&vb_buf->vb.vb2_buf, 0);
 
 		if (!dst) {
+			sc0710_dma_zc_unmapped_done(ch, vb_buf);
 			spin_unlock_irqrestore(&client->buffer_lock, buf_flags);
 			continue;
 		}
@@ -525,7 +930,7 @@ static void sc0710_dma_dequeue_video(struct sc0710_dma_channel *ch,
 				memcpy(dst, src_frame, buffer_size);
 				vb2_set_plane_payload(&vb_buf->vb.vb2_buf, 0, buffer_size);
 			}
-		} else {
+		} else if (chain) {
 			int len;
 			if (source_framesize > buffer_size) {
 				len = sc0710_dma_chain_dq_to_ptr(ch, chain, dst, buffer_size);
@@ -534,22 +939,39 @@ static void sc0710_dma_dequeue_video(struct sc0710_dma_channel *ch,
 				len = sc0710_dma_chain_dq_to_ptr(ch, chain, dst, source_framesize);
 				vb2_set_plane_payload(&vb_buf->vb.vb2_buf, 0, source_framesize);
 			}
+		} else {
+			/* A snapshot always has a source frame; never read a
+			 * chain that is not ours. */
+			spin_unlock_irqrestore(&client->buffer_lock, buf_flags);
+			continue;
 		}
 
-		vb_buf->vb.vb2_buf.timestamp = ktime_get_ns();
-		vb_buf->vb.sequence = ch->frame_sequence;
-		vb_buf->vb.field = cached_interlaced ?
-			V4L2_FIELD_INTERLACED : V4L2_FIELD_NONE;
-
 		list_del(&vb_buf->list);
-		vb2_buffer_done(&vb_buf->vb.vb2_buf, VB2_BUF_STATE_DONE);
+		sc0710_dma_buffer_finish(ch, client, vb_buf, ts_ns, sequence,
+			cached_interlaced, t_start);
 		delivered = 1;
 
 		spin_unlock_irqrestore(&client->buffer_lock, buf_flags);
 	}
-	ch->frame_sequence++;
+
+	/* The weave target goes out unless its client stopped streaming
+	 * meanwhile; then it goes back, and that client's STREAMOFF returns
+	 * it once this pass drops ch->lock. */
+	if (weave_buf && weave_client->streaming) {
+		vb2_set_plane_payload(&weave_buf->vb.vb2_buf, 0, source_framesize);
+		sc0710_dma_buffer_finish(ch, weave_client, weave_buf, ts_ns,
+			sequence, cached_interlaced, t_start);
+		delivered = 1;
+	} else if (weave_buf) {
+		sc0710_dma_requeue_head(weave_client, weave_buf);
+	}
 	spin_unlock_irqrestore(&ch->client_list_lock, flags);
 
+	if (delivered) {
+		ch->frames_out++;
+		sc0710_stat_add(&ch->stats, SC0710_STAT_COPIES, 1);
+	}
+
 	/* Count for the zero-copy split only when a client actually got the
 	 * frame; drops and skips count in neither bucket. */
 	if (zero_copy && delivered)
@@ -566,6 +988,165 @@ static void sc0710_dma_dequeue_video(struct sc0710_dma_channel *ch,
 		mod_timer(&ch->timeout, jiffies + VBUF_TIMEOUT);
 }
 
+/* Completed-frame handoff, stage two: deliver queued snapshots oldest
+ * first. Runs on the device's ordered delivery workqueue without ch->lock
+ * or kthread_dma_lock, so the service loop keeps re-arming chains (and
+ * STREAMOFF/resync get the lock) while a frame is tonemapped and copied.
+ * Everything the service loop also writes (sequence, tear validation,
+ * staging sizes) was settled at admission; the frame's latency samples
+ * are the worker's alone, as stage one never delivers inline while a
+ * snapshot is queued. */
+static void sc0710_dma_handoff_work(struct work_struct *work)
+{
+	struct sc0710_dma_channel *ch =
+		container_of(work, struct sc0710_dma_channel, handoff_work);
+	struct sc0710_handoff_slot *slot;
+	unsigned long flags;
+
+	for (;;) {
+		spin_lock_irqsave(&ch->handoff_lock, flags);
+		if (ch->handoff_count == 0) {
+			spin_unlock_irqrestore(&ch->handoff_lock, flags);
+			break;
+		}
+		slot = &ch->handoff[ch->handoff_head];
+		spin_unlock_irqrestore(&ch->handoff_lock, flags);
+
+		sc0710_dma_dequeue_video(ch, NULL, slot->buf, slot->ts_ns,
+			slot->sequence, slot->framesize, slot->width, slot->height,
+			slot->interlaced);
+
+		spin_lock_irqsave(&ch->handoff_lock, flags);
+		ch->handoff_head = (ch->handoff_head + 1) % SC0710_HANDOFF_SLOTS;
+		ch->handoff_count--;
+		ch->handoff_frames++;
+		spin_unlock_irqrestore(&ch->handoff_lock, flags);
+	}
+}
+
+/* Number an admitted frame, skipping the frames dropped since the last
+ * one so clients see the gap. Stage one, ch->lock held; client_list_lock
+ * orders it against the placeholder timer, which numbers its frames from
+ * the same counter. */
+static u32 sc0710_dma_video_sequence(struct sc0710_dma_channel *ch)
+{
+	unsigned long flags;
+	u32 seq;
+
+	spin_lock_irqsave(&ch->client_list_lock, flags);
+	seq = ch->frame_sequence + ch->seq_gap_pending;
+	ch->frame_sequence = seq + 1;
+	spin_unlock_irqrestore(&ch->client_list_lock, flags);
+	ch->seq_gap_pending = 0;
+	return seq;
+}
+
+/* Completed-frame handoff, stage one (service loop, ch->lock held): admit
+ * the frame and either deliver it inline or snapshot the chain into the
+ * next free slot for the delivery worker. The snapshot is a single
+ * sequential read of the lap; the chain is re-armed as soon as we return.
+ *
+ * Once anything is queued, frames keep going through the queue until it
+ * drains, even if frame_handoff was just cleared: delivery order and the
+ * shared staging buffers both depend on one stage-two path at a time. */
+static void sc0710_dma_video_complete(struct sc0710_dma_channel *ch,
+	struct sc0710_dma_descriptor_chain *chain,
+	u64 ts_ns,
+	u32 cached_framesize,
+	u32 cached_width,
+	u32 cached_height,
+	u32 cached_interlaced)
+{
+	struct sc0710_dev *dev = ch->dev;
+	struct sc0710_handoff_slot *slot;
+	unsigned long flags;
+	u32 count, tail;
+
+	if (!sc0710_dma_video_admit(ch, chain, cached_framesize, cached_interlaced))
+		return;
+
+	spin_lock_irqsave(&ch->handoff_lock, flags);
+	count = ch->handoff_count;
+	tail = (ch->handoff_head + count) % SC0710_HANDOFF_SLOTS;
+	spin_unlock_irqrestore(&ch->handoff_lock, flags);
+
+	/* Zero-copy delivers targeted chains in the service loop; frame
+	 * order across the two paths needs the copy path there too. */
+	if (count == 0 && (!frame_handoff || zero_copy || !dev->dq_wq)) {
+		sc0710_dma_dequeue_video(ch, chain, NULL, ts_ns,
+			sc0710_dma_video_sequence(ch), cached_framesize,
+			cached_width, cached_height, cached_interlaced);
+		return;
+	}
+
+	if (count == SC0710_HANDOFF_SLOTS) {
+		ch->handoff_drops++;
+		ch->seq_gap_pending++;
+		sc0710_stat_add(&ch->stats, SC0710_STAT_DROPS, 1);
+		return;
+	}
+
+	slot = &ch->handoff[tail];
+	if (!slot->buf || slot->size < cached_framesize) {
+		vfree(slot->buf);
+		slot->buf = vmalloc(cached_framesize);
+		slot->size = slot->buf ? cached_framesize : 0;
+		if (!slot->buf) {
+			printk_ratelimited(KERN_ERR "%s: Failed to allocate frame handoff slot (%u bytes)\n",
+				dev->name, cached_framesize);
+			if (count == 0) {
+				sc0710_dma_dequeue_video(ch, chain, NULL, ts_ns,
+					sc0710_dma_video_sequence(ch),
+					cached_framesize, cached_width,
+					cached_height, cached_interlaced);
+			} else {
+				ch->handoff_drops++;
+				ch->seq_gap_pending++;
+				sc0710_stat_add(&ch->stats, SC0710_STAT_DROPS, 1);
+			}
+			return;
+		}
+	}
+
+	if (sc0710_dma_chain_dq_to_ptr(ch, chain, slot->buf, cached_framesize) !=
+	    (int)cached_framesize) {
+		dprintk(1, "%s() short chain read - dropping\n", __func__);
+		ch->handoff_drops++;
+		ch->seq_gap_pending++;
+		sc0710_stat_add(&ch->stats, SC0710_STAT_DROPS, 1);
+		return;
+	}
+
+	/* The snapshot is contiguous: validate it here rather than on the
+	 * worker, and give its weave a buffer the worker won't see move. */
+	if (ch->tear_validation_frames_left > 0)
+		sc0710_dma_tear_validate(ch, NULL, slot->buf, true,
+			cached_framesize, cached_width, cached_height);
+	if (cached_interlaced)
+		sc0710_dma_weave_staging(dev, cached_framesize);
+
+	slot->framesize = cached_framesize;
+	slot->width = cached_width;
+	slot->height = cached_height;
+	slot->interlaced = cached_interlaced;
+	slot->ts_ns = ts_ns;
+	slot->sequence = sc0710_dma_video_sequence(ch);
+
+	spin_lock_irqsave(&ch->handoff_lock, flags);
+	ch->handoff_count++;
+	spin_unlock_irqrestore(&ch->handoff_lock, flags);
+
+	queue_work(dev->dq_wq, &ch->handoff_work);
+}
+
+/* Wait until every queued snapshot has been delivered. Never call it from
+ * the delivery worker; holding ch->lock or kthread_dma_lock is fine, the
+ * worker takes neither. */
+void sc0710_dma_channel_handoff_flush(struct sc0710_dma_channel *ch)
+{
+	if (ch->dev->dq_wq)
+		flush_work(&ch->handoff_work);
+}
 
 /* Copy the contains of the audio chain into linux audio subsystem.
  */
@@ -609,6 +1190,45 @@ struct sc0710_zc_piece {
 	u32        len;
 };
 
+/* Check that a buffer's DMA segments can back a frame of @framesize
+ * bytes cut into @npieces descriptors: the frame-covering segments must be
+ * non-empty, lie inside the device's DMA mask (an exporter mapping an
+ * imported dma-buf need not have honoured it) and number no more than the
+ * pieces. */
+static int sc0710_dma_zc_check(struct sc0710_dma_channel *ch,
+	const struct sc0710_buffer *buf, u32 framesize, u32 npieces)
+{
+	u64 mask = dma_get_mask(&ch->dev->pci->dev);
+	u32 remaining = framesize;
+	u32 nused = 0;
+	u32 i, len;
+
+	for (i = 0; i < buf->zc_nsegs && remaining; i++) {
+		len = min(buf->zc_seg[i].len, remaining);
+		if (len == 0)
+			return -EINVAL;
+		if ((u64)buf->zc_seg[i].addr + len - 1 > mask)
+			return -ERANGE;
+		remaining -= len;
+		nused++;
+	}
+	if (remaining)
+		return -EINVAL;
+	if (nused > npieces)
+		return -E2BIG;
+
+	return 0;
+}
+
+/* buf_prepare's check for imported buffers, against the pieces a chain
+ * for @framesize is cut into. */
+int sc0710_dma_zc_validate(struct sc0710_dma_channel *ch,
+	const struct sc0710_buffer *buf, u32 framesize)
+{
+	return sc0710_dma_zc_check(ch, buf, framesize,
+		sc0710_dma_chain_segments(ch, framesize));
+}
+
 /* Split the buffer's mapped DMA segments into exactly numAllocations
  * contiguous pieces summing to the chain's transfer size, so the descriptor
  * count (and with it the next pointers and the one-time credit programming)
@@ -616,8 +1236,10 @@ struct sc0710_zc_piece {
  * descriptor's length is rewritten anyway - so the frame's bytes in each
  * segment are tiled with that segment's share of the pieces; a piece only
  * must not span segments. Returns false when the buffer can't back this
- * chain (more frame-covering segments than descriptors). */
-static bool sc0710_dma_chain_carve(const struct sc0710_dma_descriptor_chain *chain,
+ * chain (see sc0710_dma_zc_check()) or a piece would overflow a
+ * descriptor's length field. */
+static bool sc0710_dma_chain_carve(struct sc0710_dma_channel *ch,
+	const struct sc0710_dma_descriptor_chain *chain,
 	const struct sc0710_buffer *buf,
 	struct sc0710_zc_piece pieces[SC0710_MAX_CHAIN_DESCRIPTORS])
 {
@@ -629,6 +1251,8 @@ static bool sc0710_dma_chain_carve(const struct sc0710_dma_descriptor_chain *cha
 
 	if (buf->zc_nsegs == 0 || remaining == 0)
 		return false;
+	if (sc0710_dma_zc_check(ch, buf, remaining, npieces) < 0)
+		return false;
 
 	/* The frame occupies the first total_transfer_size bytes; clip each
 	 * segment to its frame-covering share. */
@@ -637,8 +1261,6 @@ static bool sc0710_dma_chain_carve(const struct sc0710_dma_descriptor_chain *cha
 		remaining -= used[nused];
 		nused++;
 	}
-	if (remaining || nused > npieces)
-		return false;
 
 	for (i = 0; i < nused; i++) {
 		/* Remaining pieces over remaining segments, front-loaded;
@@ -648,7 +1270,7 @@ static bool sc0710_dma_chain_carve(const struct sc0710_dma_descriptor_chain *cha
 
 		while (k--) {
 			chunk = k ? (used[i] - off) / (k + 1) : used[i] - off;
-			if (chunk == 0)
+			if (chunk == 0 || chunk > DMA_DESC_MAX_BYTES)
 				return false;
 			pieces[j].addr = buf->zc_seg[i].addr + off;
 			pieces[j].len  = chunk;
@@ -739,6 +1361,64 @@ static u32 sc0710_dma_chain_stale_scan(struct sc0710_dma_channel *ch,
 	return stale;
 }
 
+const char *sc0710_zc_state_ascii(enum sc0710_zc_state_e state)
+{
+	switch (state) {
+	case ZC_STATE_ACTIVE:    return "active";
+	case ZC_STATE_TRIPPED:   return "tripped";
+	case ZC_STATE_PROBATION: return "probation";
+	case ZC_STATE_DISABLED:  return "disabled";
+	}
+	return "unknown";
+}
+
+/* A stale descriptor was consumed: force the copy path. A trip on
+ * probation, or the DMA_ZC_MAX_TRIPS'th within the trip window, disables
+ * zero-copy for the session; otherwise the resync this schedules re-arms
+ * it on probation. Caller holds ch->lock. */
+static void sc0710_dma_zc_trip(struct sc0710_dma_channel *ch)
+{
+	struct sc0710_dev *dev = ch->dev;
+	u64 now = ktime_get_ns();
+
+	if (ch->zc_trip_last_ns && now - ch->zc_trip_last_ns < DMA_ZC_TRIP_WINDOW_NS)
+		ch->zc_trips_recent++;
+	else
+		ch->zc_trips_recent = 1;
+	ch->zc_trip_last_ns = now;
+	ch->zc_trips++;
+	ch->zc_stale_trip = true;
+
+	if (ch->zc_state == ZC_STATE_PROBATION ||
+	    ch->zc_trips_recent >= DMA_ZC_MAX_TRIPS)
+		ch->zc_state = ZC_STATE_DISABLED;
+	else
+		ch->zc_state = ZC_STATE_TRIPPED;
+
+	printk(KERN_ERR "%s: [ch%d] zero-copy: stale descriptor "
+		"writeback detected - a delivered frame may have been "
+		"overwritten; %s and scheduling a DMA resync\n", dev->name, ch->nr,
+		ch->zc_state == ZC_STATE_DISABLED ?
+		"disabling zero-copy for this session" :
+		"holding the copy path until the ring is rebuilt");
+}
+
+/* Resync hook: the engine is stopped and every chain points back at the
+ * scratch ring, so a tripped channel can resume targeting - on probation
+ * until DMA_ZC_PROBATION_LAPS laps pass the sentinel clean. */
+void sc0710_dma_channel_zc_rearm(struct sc0710_dma_channel *ch)
+{
+	mutex_lock(&ch->lock);
+	if (ch->zc_state == ZC_STATE_TRIPPED) {
+		ch->zc_state = ZC_STATE_PROBATION;
+		ch->zc_probation_laps = DMA_ZC_PROBATION_LAPS;
+		ch->zc_stale_trip = false;
+		printk(KERN_INFO "%s: [ch%d] zero-copy: ring rebuilt, re-enabling targeting on probation\n",
+			ch->dev->name, ch->nr);
+	}
+	mutex_unlock(&ch->lock);
+}
+
 /* Point the chain's descriptors back at its own coherent allocations.
  * Caller holds ch->lock and has verified the engine can't be fetching
  * these descriptors (chain just completed, or engine stopped). */
@@ -788,12 +1468,21 @@ static void sc0710_dma_chain_try_target(struct sc0710_dma_channel *ch, int chain
 	if (!buf)
 		return;
 
-	if (!sc0710_dma_chain_carve(chain, buf, pieces)) {
+	/* Under the host tonemap a targeted frame is tonemapped in place,
+	 * which a buffer needing syncs can't publish: copy path. */
+	if (buf->zc_need_sync && sc0710_want_sw_tonemap(dev)) {
+		sc0710_dma_requeue_head(client, buf);
+		return;
+	}
+
+	if (!sc0710_dma_chain_carve(ch, chain, buf, pieces)) {
 		dprintk(2, "%s() carve failed (%u segs for %u pieces), copy path\n",
 			__func__, buf->zc_nsegs, chain->numAllocations);
-		spin_lock_irqsave(&client->buffer_lock, flags);
-		list_add(&buf->list, &client->buffer_list);
-		spin_unlock_irqrestore(&client->buffer_lock, flags);
+		if (buf->zc_nsegs) {
+			buf->zc_rejected++;
+			ch->zc_carve_rejects++;
+		}
+		sc0710_dma_requeue_head(client, buf);
 		return;
 	}
 
@@ -806,13 +1495,131 @@ static void sc0710_dma_chain_try_target(struct sc0710_dma_channel *ch, int chain
 	wmb();
 	chain->target_buf = buf;
 	chain->target_client = client;
+	trace_sc0710_zc_retarget(dev->nr, ch->nr, chain_idx,
+		buf->vb.vb2_buf.index, buf->zc_nsegs);
+}
+
+/* Host tonemap in place on a zero-copy frame, while the buffer is still
+ * driver-owned. Only for buffers that need no DMA syncs (zc_need_sync
+ * clear): a sync for the device does not publish CPU writes to a
+ * DMA_FROM_DEVICE mapping, so under a bounce buffer or on a non-coherent
+ * host the DQBUF-time CPU sync would bring the raw frame back. Those go
+ * through the copy path instead. Sleeps (pixel pool). Returns false for
+ * an unmapped imported buffer, which can't be tonemapped. */
+static bool sc0710_dma_tonemap_targeted(struct sc0710_dma_channel *ch,
+	struct sc0710_buffer *buf, struct sc0710_client *client)
+{
+	struct sc0710_dev *dev = ch->dev;
+	struct sc0710_px_job job = {
+		.ch = ch,
+		.dst = sc0710_buf_vaddr(buf),
+		.width = client->stream_width,
+		.height = client->stream_height,
+		.tonemap = true,
+	};
+
+	if (!job.dst)
+		return false;
+
+	sc0710_px_run(dev, job.height, sc0710_px_tonemap, &job);
+	ch->zc_frames_tonemapped++;
+	return true;
+}
+
+/* Zero-copy fan-out: hand every other client locked to the source format
+ * a copy of the frame the hardware placed in the lead client's buffer. The
+ * lead buffer is still driver-owned here (not yet vb2_buffer_done), and
+ * its pages are cached memory, so this is one copy per extra client with
+ * no scratch-ring read at all. Clients are matched on the locked size and
+ * frame size, as the lead was (sc0710_dma_zc_client()), and their copies
+ * are finished like any copy-path delivery. Returns the number of copies
+ * delivered. */
+static int sc0710_dma_fanout_direct(struct sc0710_dma_channel *ch,
+	struct sc0710_buffer *lead_buf, struct sc0710_client *lead,
+	u32 bytes, u64 ts_ns, u64 t_start)
+{
+	struct sc0710_dev *dev = ch->dev;
+	struct sc0710_client *client;
+	struct sc0710_buffer *vb_buf;
+	unsigned long flags, buf_flags;
+	const u8 *src = NULL;
+	u8 *dst;
+	int copies = 0;
+
+	spin_lock_irqsave(&ch->client_list_lock, flags);
+	list_for_each_entry(client, &ch->client_list, list) {
+		if (client == lead || !client->streaming)
+			continue;
+		if (client->stream_width != lead->stream_width ||
+		    client->stream_height != lead->stream_height ||
+		    client->stream_framesize != bytes)
+			continue;
+
+		spin_lock_irqsave(&client->buffer_lock, buf_flags);
+		if (list_empty(&client->buffer_list)) {
+			spin_unlock_irqrestore(&client->buffer_lock, buf_flags);
+			continue;
+		}
+		vb_buf = list_first_entry(&client->buffer_list, struct sc0710_buffer, list);
+		dst = sc0710_buf_vaddr(vb_buf);
+		if (!dst) {
+			sc0710_dma_zc_unmapped_done(ch, vb_buf);
+			spin_unlock_irqrestore(&client->buffer_lock, buf_flags);
+			continue;
+		}
+
+		/* First taker: make the device's writes CPU-visible (a no-op
+		 * on coherent x86, a bounce copy under swiotlb). */
+		if (!src) {
+			dma_sync_sgtable_for_cpu(&dev->pci->dev,
+				vb2_dma_sg_plane_desc(&lead_buf->vb.vb2_buf, 0),
+				DMA_FROM_DEVICE);
+			src = sc0710_buf_vaddr(lead_buf);
+			if (!src) {
+				spin_unlock_irqrestore(&client->buffer_lock, buf_flags);
+				break;
+			}
+		}
+
+		/* QBUF validates against the locked frame size, so this only
+		 * catches a buffer queued before the lock; never hand out a
+		 * truncated frame as a good one. */
+		if (vb2_plane_size(&vb_buf->vb.vb2_buf, 0) < bytes) {
+			list_del(&vb_buf->list);
+			vb2_buffer_done(&vb_buf->vb.vb2_buf, VB2_BUF_STATE_ERROR);
+			spin_unlock_irqrestore(&client->buffer_lock, buf_flags);
+			printk_ratelimited(KERN_WARNING "%s: zero-copy: buffer smaller than the %u-byte frame, returning it as an error\n",
+				dev->name, bytes);
+			continue;
+		}
+
+		memcpy(dst, src, bytes);
+		vb2_set_plane_payload(&vb_buf->vb.vb2_buf, 0, bytes);
+		list_del(&vb_buf->list);
+		sc0710_dma_buffer_finish(ch, client, vb_buf, ts_ns,
+			lead_buf->vb.sequence, 0, t_start);
+		spin_unlock_irqrestore(&client->buffer_lock, buf_flags);
+		copies++;
+	}
+	spin_unlock_irqrestore(&ch->client_list_lock, flags);
+
+	if (copies)
+		sc0710_stat_add(&ch->stats, SC0710_STAT_COPIES, 1);
+
+	return copies;
 }
 
 /* Deliver a frame the hardware already placed in the targeted buffer. */
 static void sc0710_dma_deliver_targeted(struct sc0710_dma_channel *ch,
-	struct sc0710_dma_descriptor_chain *chain)
+	struct sc0710_dma_descriptor_chain *chain, u64 ts_ns)
 {
 	struct sc0710_buffer *buf = chain->target_buf;
+	struct sc0710_client *client = chain->target_client;
+	u64 t_start = ktime_get_ns();
+	int copies;
+
+	if (t_start > ts_ns)
+		sc0710_lat_record(&ch->lat_detect, t_start - ts_ns);
 
 	/* Point the chain back at scratch before handing the buffer over:
 	 * whether or not a new buffer gets targeted afterwards, the chain
@@ -821,12 +1628,38 @@ static void sc0710_dma_deliver_targeted(struct sc0710_dma_channel *ch,
 	sc0710_dma_chain_target_scratch(chain);
 
 	vb2_set_plane_payload(&buf->vb.vb2_buf, 0, chain->total_transfer_size);
-	buf->vb.vb2_buf.timestamp = ktime_get_ns();
-	buf->vb.sequence = ch->frame_sequence++;
+	buf->vb.vb2_buf.timestamp = ts_ns;
+	buf->vb.sequence = sc0710_dma_video_sequence(ch);
 	buf->vb.field = V4L2_FIELD_NONE;
+
+	/* Checked per frame: tonemap may flip mid-session, and a zero-copy
+	 * frame must never go out un-tonemapped - an unmapped import gets
+	 * the buffer back flagged as an error instead. */
+	if (sc0710_want_sw_tonemap(ch->dev) &&
+	    !sc0710_dma_tonemap_targeted(ch, buf, client)) {
+		printk_ratelimited(KERN_WARNING "%s: zero-copy: imported buffer has no kernel mapping for the host tonemap, returning it as an error\n",
+			ch->dev->name);
+		atomic64_inc(&ch->zc_import_errors);
+		vb2_buffer_done(&buf->vb.vb2_buf, VB2_BUF_STATE_ERROR);
+		mod_timer(&ch->timeout, jiffies + VBUF_TIMEOUT);
+		return;
+	}
+
+	copies = sc0710_dma_fanout_direct(ch, buf, client,
+		chain->total_transfer_size, ts_ns, t_start);
+	ch->zc_frames_shared += copies;
+
+	buf->done_ns = ktime_get_ns();
+	sc0710_lat_record(&ch->lat_deliver, buf->done_ns - t_start);
+	trace_sc0710_buffer_done(ch->dev->nr, ch->nr, client,
+		buf->vb.vb2_buf.index, buf->vb.sequence, ts_ns,
+		chain->total_transfer_size, true);
+	sc0710_dma_zc_account(ch, buf, true);
 	vb2_buffer_done(&buf->vb.vb2_buf, VB2_BUF_STATE_DONE);
 
 	ch->zc_frames_direct++;
+	ch->frames_out++;
+	sc0710_stat_add(&ch->stats, SC0710_STAT_ZC_HITS, 1);
 
 	/* Re-set the buffer timeout */
 	mod_timer(&ch->timeout, jiffies + VBUF_TIMEOUT);
@@ -865,27 +1698,42 @@ void sc0710_dma_channel_untarget_all(struct sc0710_dma_channel *ch)
 	mutex_unlock(&ch->lock);
 }
 
+/* Whether any chain currently DMA-targets one of the client's buffers.
+ * A client leaving while others keep streaming must get those buffers
+ * back before vb2 unmaps them. */
+bool sc0710_dma_channel_targets(struct sc0710_dma_channel *ch,
+	struct sc0710_client *client)
+{
+	bool targeted = false;
+	int i;
+
+	mutex_lock(&ch->lock);
+	for (i = 0; i < ch->numDescriptorChains; i++)
+		if (ch->chains[i].target_client == client)
+			targeted = true;
+	mutex_unlock(&ch->lock);
+
+	return targeted;
+}
+
 /* Zero-copy is engaged per completed chain, and only when the whole frame
- * can land in the client's buffer exactly as the source produced it: one
- * streaming client, progressive, client negotiated the source format, no
- * post-resync frame dropping and no tear-validation window (both read
- * frames from the scratch ring). Returns the client, or NULL for the copy
- * path. Caller holds ch->lock. */
+ * can land in a client's buffer exactly as the source produced it:
+ * progressive, no post-resync frame dropping and no tear-validation window
+ * (both read frames from the scratch ring). The DMA targets the lead - the
+ * first streaming client (in open order) that negotiated the source
+ * format - and the other clients get copies of the lead's frame. Returns
+ * the lead, or NULL for the copy path. Caller holds ch->lock. */
 static struct sc0710_client *sc0710_dma_zc_client(struct sc0710_dma_channel *ch,
 	u32 cached_framesize, u32 cached_width, u32 cached_height,
 	u32 cached_interlaced)
 {
 	struct sc0710_client *client, *zc_client = NULL;
 	unsigned long flags;
-	int streaming = 0;
 
 	if (!zero_copy || ch->mediatype != CHTYPE_VIDEO)
 		return NULL;
 	if (ch->zc_stale_trip)
 		return NULL;
-	/* Host tonemap needs a gather/copy path; never DMA into client buffers. */
-	if (sc0710_want_sw_tonemap(ch->dev))
-		return NULL;
 	if (cached_framesize == 0 || cached_interlaced)
 		return NULL;
 	if (ch->skip_next_frames || ch->tear_validation_frames_left)
@@ -893,22 +1741,119 @@ static struct sc0710_client *sc0710_dma_zc_client(struct sc0710_dma_channel *ch,
 
 	spin_lock_irqsave(&ch->client_list_lock, flags);
 	list_for_each_entry(client, &ch->client_list, list) {
-		if (!client->streaming)
+		if (!client->streaming ||
+		    client->stream_width != cached_width ||
+		    client->stream_height != cached_height ||
+		    client->stream_framesize != cached_framesize)
 			continue;
-		streaming++;
 		zc_client = client;
+		break;
 	}
 	spin_unlock_irqrestore(&ch->client_list_lock, flags);
 
-	if (streaming != 1 ||
-	    zc_client->stream_width != cached_width ||
-	    zc_client->stream_height != cached_height ||
-	    zc_client->stream_framesize != cached_framesize)
-		return NULL;
-
 	return zc_client;
 }
 
+/* Capture timestamp jitter: each frame interval's deviation from the
+ * smoothed frame period. Intervals outside half to one and a half periods
+ * (a dropped frame, usually) are counted as gaps rather than jitter; a
+ * run of them means the period itself changed, and it is re-seeded. */
+static void sc0710_dma_ts_account(struct sc0710_dma_channel *ch, u64 ts,
+	bool from_irq)
+{
+	static const u32 edges_us[SC0710_TS_JITTER_BUCKETS - 1] = {
+		50, 100, 250, 500, 1000, 2000, 5000
+	};
+	u64 interval, jitter;
+	int b;
+
+	if (from_irq)
+		ch->ts_from_irq++;
+	else
+		ch->ts_from_poll++;
+
+	if (!ch->ts_last_ns || ts <= ch->ts_last_ns) {
+		ch->ts_last_ns = ts;
+		return;
+	}
+	interval = ts - ch->ts_last_ns;
+	ch->ts_last_ns = ts;
+
+	if (!ch->ts_period_ns || ch->ts_reject_streak >= 8) {
+		ch->ts_period_ns = interval;
+		ch->ts_reject_streak = 0;
+		return;
+	}
+
+	if (interval * 2 > ch->ts_period_ns * 3 ||
+	    interval * 2 < ch->ts_period_ns) {
+		ch->ts_gaps++;
+		ch->ts_reject_streak++;
+		return;
+	}
+	ch->ts_reject_streak = 0;
+
+	if (interval > ch->ts_period_ns) {
+		jitter = interval - ch->ts_period_ns;
+		ch->ts_period_ns += jitter >> 4;
+	} else {
+		jitter = ch->ts_period_ns - interval;
+		ch->ts_period_ns -= jitter >> 4;
+	}
+
+	for (b = 0; b < ARRAY_SIZE(edges_us); b++)
+		if (jitter < (u64)edges_us[b] * 1000)
+			break;
+	ch->ts_jitter_hist[b]++;
+	ch->ts_jitter_sum_ns += jitter;
+	ch->ts_jitter_samples++;
+	if (jitter > ch->ts_jitter_max_ns)
+		ch->ts_jitter_max_ns = jitter;
+}
+
+/* The completion interrupt stamp of a chain the service pass consumes:
+ * the first stamp whose count reached the chain's end. Older stamps belong
+ * to chains already consumed (or lost to an overrun) and are dropped; a
+ * stamp that also covers the next chain is left for it too, since it is
+ * the first time either was known complete. 0 if the chain's interrupt
+ * has not been taken yet - it completed after the pass read the counter -
+ * and the stamp that arrives for it later is dropped by the next chain. */
+static u64 sc0710_dma_chain_irq_ts(struct sc0710_dma_channel *ch,
+	struct sc0710_dma_descriptor_chain *chain)
+{
+	u32 end = ch->ts_desc_done + chain->numAllocations;
+	struct sc0710_irq_stamp st;
+	u32 head;
+
+	ch->ts_desc_done = end;
+
+	for (;;) {
+		head = atomic_read(&ch->irq_ts_head);
+		if (head - ch->irq_ts_tail > SC0710_IRQ_TS_RING)
+			ch->irq_ts_tail = head - SC0710_IRQ_TS_RING;
+		if (ch->irq_ts_tail == head)
+			return 0;
+		smp_rmb();
+		st = ch->irq_ts_ring[ch->irq_ts_tail & (SC0710_IRQ_TS_RING - 1)];
+		smp_rmb();
+
+		/* The interrupt may have been rewriting this slot while we
+		 * read it: drop it. */
+		if (atomic_read(&ch->irq_ts_head) - ch->irq_ts_tail >= SC0710_IRQ_TS_RING) {
+			ch->irq_ts_tail++;
+			continue;
+		}
+
+		if (st.ns < ch->ts_session_ns || (s32)(st.count - end) < 0) {
+			ch->irq_ts_tail++;
+			continue;
+		}
+		if ((s32)(st.count - end) < (s32)chain->numAllocations)
+			ch->irq_ts_tail++;
+		return st.ns;
+	}
+}
+
 int sc0710_dma_channel_service(struct sc0710_dma_channel *ch)
 {
 	struct sc0710_dev *dev = ch->dev;
@@ -920,9 +1865,12 @@ int sc0710_dma_channel_service(struct sc0710_dma_channel *ch)
 	u32 cached_width, cached_height;
 	u32 cached_interlaced;
 	u32 wbm[2];
-	u32 v;
+	u32 v, delta;
+	u64 t0, hold, irq_ts, frame_ts = 0;
+	s64 backlog;
 	bool sentinel;
 	bool stale_completion;
+	u32 stale;
 	int consumed = 0;
 	int i;
 
@@ -959,9 +1907,18 @@ int sc0710_dma_channel_service(struct sc0710_dma_channel *ch)
 	}
 
 	dprintk(3, "ch#%d    was %d now %d\n", ch->nr, ch->dma_completed_descriptor_count_last, v);
+	t0 = ktime_get_ns();
+	delta = v - ch->dma_completed_descriptor_count_last;
 	ch->dma_completed_descriptor_count_last = v;
 	ch->dma_last_completion_jiffies = jiffies;
 
+	/* More than a ring's worth completed since the last chain consumed:
+	 * the engine lapped unserviced chains (counted as overruns below).
+	 * Pair the chains still in the ring with the newest completions. */
+	if (ch->sg_total_descriptors &&
+	    (s32)(v - ch->ts_desc_done) > (s32)ch->sg_total_descriptors)
+		ch->ts_desc_done = v - ch->sg_total_descriptors;
+
 	zc_client = sc0710_dma_zc_client(ch, cached_framesize,
 		cached_width, cached_height, cached_interlaced);
 
@@ -1003,21 +1960,24 @@ int sc0710_dma_channel_service(struct sc0710_dma_channel *ch)
 		 * need to process a complete video/audio transfer.
 		 */
 		if (wbm[0] && wbm[1]) {
-			if (sentinel && sc0710_dma_chain_stale_scan(ch, chain) &&
-			    !ch->zc_stale_trip) {
+			trace_sc0710_chain_complete(dev->nr, ch->nr, i,
+				wbm[0], wbm[1], stale_completion);
+
+			stale = sentinel ? sc0710_dma_chain_stale_scan(ch, chain) : 0;
+			if (stale)
+				trace_sc0710_zc_stale(dev->nr, ch->nr, i, stale,
+					!ch->zc_stale_trip);
+			if (stale && !ch->zc_stale_trip) {
 				/* The device consumed a pre-rewrite descriptor:
 				 * its read-ahead outran the credit gating, and a
 				 * frame may already have landed in a delivered
-				 * buffer. Permanently force the copy path; the
-				 * resync rebuilds the ring with the engine
-				 * stopped and returns held buffers. */
-				ch->zc_stale_trip = true;
+				 * buffer. Force the copy path; the resync
+				 * rebuilds the ring with the engine stopped,
+				 * returns held buffers and decides whether
+				 * targeting comes back. */
+				sc0710_dma_zc_trip(ch);
 				dev->tear_resync_pending = 1;
 				zc_client = NULL;
-				printk(KERN_ERR "%s: [ch%d] zero-copy: stale descriptor "
-					"writeback detected - a delivered frame may have been "
-					"overwritten; disabling zero-copy targeting and "
-					"scheduling a DMA resync\n", dev->name, ch->nr);
 			}
 
 			/* A tripped sentinel holds a targeted chain untouched
@@ -1040,8 +2000,9 @@ int sc0710_dma_channel_service(struct sc0710_dma_channel *ch)
 			}
 
 			/* Update some internal stats that measure throughput. */
-			sc0710_things_per_second_update(&ch->bitsPerSecond, chain->total_transfer_size * 8);
-			sc0710_things_per_second_update(&ch->descPerSecond, chain->numAllocations);
+			sc0710_stat_add(&ch->stats, SC0710_STAT_BYTES, chain->total_transfer_size);
+			sc0710_stat_add(&ch->stats, SC0710_STAT_DESCS, chain->numAllocations);
+			sc0710_stat_add(&ch->stats, SC0710_STAT_FRAMES, 1);
 
 			/* Service the audio, or video.
 			 * Pass cached_framesize to prevent mid-operation format changes.
@@ -1050,28 +2011,52 @@ int sc0710_dma_channel_service(struct sc0710_dma_channel *ch)
 			 * to that descriptor's old address, not the scratch ring,
 			 * so there is no frame to deliver - housekeeping still runs
 			 * below so the ring keeps turning until the resync. */
+			/* Streaming scratch: the lap is CPU-visible from here
+			 * until the sync back below. */
+			if (ch->mediatype == CHTYPE_VIDEO)
+				sc0710_dma_chain_sync_for_cpu(ch, chain);
+
+			/* One capture timestamp per frame (or audio period),
+			 * shared by every client: this chain's own completion
+			 * interrupt, else the time the pass first saw the
+			 * counter move. A stale completion still used up its
+			 * stamp. */
+			irq_ts = sc0710_dma_chain_irq_ts(ch, chain);
+			if (!stale_completion) {
+				frame_ts = irq_ts ? irq_ts : t0;
+				sc0710_dma_ts_account(ch, frame_ts, irq_ts != 0);
+				if (irq_ts && irq_ts <= t0)
+					sc0710_lat_record(&ch->lat_service, t0 - irq_ts);
+			}
+
 			if (ch->mediatype == CHTYPE_VIDEO && !stale_completion) {
-				if (chain->target_buf) {
-					/* Tonemap may flip mid-session; never deliver
-					 * an un-tonemapped zero-copy frame. */
-					if (sc0710_want_sw_tonemap(dev)) {
-						sc0710_dma_chain_untarget(chain);
-						sc0710_dma_dequeue_video(ch, chain,
-							cached_framesize, cached_width,
-							cached_height, cached_interlaced);
-					} else {
-						sc0710_dma_deliver_targeted(ch, chain);
-					}
-				} else {
-					sc0710_dma_dequeue_video(ch, chain, cached_framesize,
+				if (chain->target_buf &&
+				    chain->target_buf->zc_need_sync &&
+				    sc0710_want_sw_tonemap(dev)) {
+					/* The tonemap came on with a buffer that
+					 * can't be tonemapped in place already
+					 * targeted: take the copy path. */
+					sc0710_dma_chain_untarget(chain);
+					sc0710_dma_video_complete(ch, chain,
+						frame_ts, cached_framesize,
 						cached_width, cached_height,
 						cached_interlaced);
+				} else if (chain->target_buf) {
+					sc0710_dma_deliver_targeted(ch, chain,
+						frame_ts);
+				} else {
+					sc0710_dma_video_complete(ch, chain, frame_ts,
+						cached_framesize, cached_width,
+						cached_height, cached_interlaced);
 				}
 			} else
 			if (ch->mediatype == CHTYPE_AUDIO) {
 				sc0710_dma_dequeue_audio(ch, chain);
 			}
 
+			if (ch->mediatype == CHTYPE_VIDEO)
+				sc0710_dma_chain_sync_for_device(ch, chain);
+
 			/* Reset the descriptor state so we know when it's complete next time. */
 			*(dca->wbm[0]) = 0;
 			*(dca->wbm[1]) = 0;
@@ -1084,9 +2069,18 @@ int sc0710_dma_channel_service(struct sc0710_dma_channel *ch)
 			/* Arm the sentinel for the next lap alongside whatever
 			 * rewrite this pass makes (scratch re-point, retarget, or
 			 * the flip itself in measurement mode). */
-			if (sentinel && !ch->zc_stale_trip)
+			if (sentinel && !ch->zc_stale_trip) {
 				sc0710_dma_chain_flip_wbm(ch, chain);
 
+				/* This lap passed the sentinel clean. */
+				if (ch->zc_state == ZC_STATE_PROBATION &&
+				    --ch->zc_probation_laps == 0) {
+					ch->zc_state = ZC_STATE_ACTIVE;
+					printk(KERN_INFO "%s: [ch%d] zero-copy: probation passed\n",
+						dev->name, ch->nr);
+				}
+			}
+
 			/* Re-arm this chain for the next lap. */
 			if (zc_client &&
 			    (u32)chain->total_transfer_size == cached_framesize)
@@ -1103,10 +2097,72 @@ int sc0710_dma_channel_service(struct sc0710_dma_channel *ch)
 		}
 	}
 
+	/* Ring overrun: without credit gating the engine laps the ring
+	 * whether or not a chain was serviced, and an unserviced lap is
+	 * simply overwritten - its writeback is seen once for two frames.
+	 * Count chains completed (from the hardware counter) against chains
+	 * consumed; a chain may complete between the counter read and the
+	 * writeback scan, so one chain of slack is never counted as lost. */
+	if (!sentinel && ch->sg_total_descriptors) {
+		ch->ring_desc_session += delta;
+		ch->ring_laps_session += consumed;
+		backlog = (s64)div_u64(ch->ring_desc_session * ch->numDescriptorChains,
+				ch->sg_total_descriptors) -
+			(s64)ch->ring_laps_session - (s64)ch->ring_lost_session;
+		if (backlog > 1) {
+			ch->ring_lost_session += backlog - 1;
+			ch->ring_overruns += backlog - 1;
+			sc0710_stat_add(&ch->stats, SC0710_STAT_DROPS, backlog - 1);
+			if (ch->mediatype == CHTYPE_VIDEO)
+				ch->seq_gap_pending += backlog - 1;
+			printk_ratelimited(KERN_WARNING "%s: [ch%d] DMA ring overrun, %lld frame(s) overwritten before service\n",
+				dev->name, ch->nr, backlog - 1);
+		}
+	}
+
+	if (consumed) {
+		hold = ktime_get_ns() - t0;
+		ch->service_hold_last_ns = hold;
+		if (hold > ch->service_hold_max_ns)
+			ch->service_hold_max_ns = hold;
+	}
+
 	mutex_unlock(&ch->lock);
 	return consumed;
 }
 
+/* Chains for a video ring of framesize-byte frames at fpsX100: four
+ * (the classic ring) at 60 Hz and below, more for high-rate sources so
+ * the ring still covers DMA_RING_TARGET_MS of service delay. Bounded by
+ * the channel's chain array and by the descriptor page. */
+static u32 sc0710_dma_channel_depth(struct sc0710_dma_channel *ch,
+	u32 framesize, u32 fpsX100)
+{
+	u32 page_descs = PAGE_SIZE / sizeof(struct sc0710_dma_descriptor);
+	u32 depth = ring_depth;
+
+	if (!depth) {
+		depth = DIV_ROUND_UP(fpsX100 * DMA_RING_TARGET_MS, 100 * MSEC_PER_SEC);
+		if (framesize)
+			depth = min_t(u32, depth, DMA_RING_BUDGET_BYTES / framesize);
+	}
+	depth = clamp_t(u32, depth, DMA_TRANSFER_CHAINS, ch->maxDescriptorChains);
+
+	return min_t(u32, depth, page_descs / sc0710_dma_chain_segments(ch, framesize));
+}
+
+/* Pool segments for the largest ring scratch_pool=1 has to hold. */
+static u32 sc0710_dma_channel_pool_segs(struct sc0710_dma_channel *ch)
+{
+	u32 depth = ring_depth ? ch->maxDescriptorChains : DMA_TRANSFER_CHAINS;
+	u32 per_seg = max_t(u32, DMA_POOL_SEG_BYTES /
+		sc0710_dma_chain_segsize(ch, DMA_POOL_MAX_FRAME), 1);
+	u32 segs = DIV_ROUND_UP(depth * sc0710_dma_chain_segments(ch, DMA_POOL_MAX_FRAME),
+		per_seg);
+
+	return max_t(u32, segs, DMA_RING_BUDGET_BYTES / DMA_POOL_SEG_BYTES);
+}
+
 /* Build the scatter gather table chaining all of the chains and decriptors together. */
 static int sc0710_dma_channel_chains_link(struct sc0710_dma_channel *ch)
 {
@@ -1117,12 +2173,15 @@ static int sc0710_dma_channel_chains_link(struct sc0710_dma_channel *ch)
 	dma_addr_t curr_wbm = ch->pt_dma + PAGE_SIZE;
 	/* Virtual address for writeback metadata - second page of coherent allocation */
 	u8 *wbm_cpu = (u8 *)ch->pt_cpu + PAGE_SIZE;
+	u32 total = 0;
 	int i, j;
 
 	/* Both pt pages bound the ring: page 1 holds the 32-byte descriptors,
 	 * page 2 the writeback slots at the same stride. */
-	BUILD_BUG_ON(SC0710_MAX_CHANNEL_DESCRIPTOR_CHAINS * SC0710_MAX_CHAIN_DESCRIPTORS *
-		     sizeof(struct sc0710_dma_descriptor) > PAGE_SIZE);
+	for (i = 0; i < ch->numDescriptorChains; i++)
+		total += ch->chains[i].numAllocations;
+	if (total * sizeof(struct sc0710_dma_descriptor) > PAGE_SIZE)
+		return -EINVAL;
 
 	/* Now that we have all of the dma allocations, we can update the descriptor tables with DMA io addresses. */
 	for (i = 0; i < ch->numDescriptorChains; i++) {
@@ -1201,6 +2260,14 @@ int sc0710_dma_channel_alloc(struct sc0710_dev *dev, u32 nr, enum sc0710_channel
 	INIT_LIST_HEAD(&ch->client_list);
 	spin_lock_init(&ch->client_list_lock);
 
+	spin_lock_init(&ch->handoff_lock);
+	INIT_WORK(&ch->handoff_work, sc0710_dma_handoff_work);
+
+	/* Freed by sc0710_dma_channel_free() even if the rest fails. */
+	ret = sc0710_stats_init(&ch->stats);
+	if (ret < 0)
+		return ret;
+
 	spin_lock_init(&ch->v4l2_capture_list_lock);
 	INIT_LIST_HEAD(&ch->v4l2_capture_list);
 
@@ -1211,9 +2278,22 @@ int sc0710_dma_channel_alloc(struct sc0710_dev *dev, u32 nr, enum sc0710_channel
 	ch->mediatype = mediatype;
 	ch->state = STATE_STOPPED;
 	ch->dma_last_completion_jiffies = 0;
-	sc0710_things_per_second_reset(&ch->bitsPerSecond);
-	sc0710_things_per_second_reset(&ch->descPerSecond);
-	sc0710_things_per_second_reset(&ch->audioSamplesPerSecond);
+
+	/* Audio's fixed transfer never needs more than the classic ring. */
+	if (ch->mediatype == CHTYPE_VIDEO)
+		ch->maxDescriptorChains = ring_depth ?
+			clamp_t(u32, ring_depth, DMA_TRANSFER_CHAINS,
+				SC0710_MAX_CHANNEL_DESCRIPTOR_CHAINS) :
+			SC0710_MAX_CHANNEL_DESCRIPTOR_CHAINS;
+	else
+		ch->maxDescriptorChains = DMA_TRANSFER_CHAINS;
+
+	/* Freed by sc0710_dma_channel_free() whatever else fails. */
+	ch->chains = kcalloc(ch->maxDescriptorChains, sizeof(*ch->chains), GFP_KERNEL);
+	if (!ch->chains) {
+		ch->enabled = 0;
+		return -ENOMEM;
+	}
 
 	if (ch->mediatype == CHTYPE_VIDEO) {
 		ch->numDescriptorChains = DMA_TRANSFER_CHAINS;
@@ -1273,6 +2353,11 @@ int sc0710_dma_channel_alloc(struct sc0710_dev *dev, u32 nr, enum sc0710_channel
         ch->reg_sg_adj = ch->register_sg_base + 0x88;
         ch->reg_sg_credits = ch->register_sg_base + 0x8c;
 
+	/* Non-fatal: without it every ring build allocates, as before. */
+	if (scratch_pool && !stream_scratch && ch->mediatype == CHTYPE_VIDEO)
+		sc0710_dma_pool_alloc(ch, sc0710_dma_channel_pool_segs(ch),
+			DMA_POOL_SEG_BYTES);
+
 	/* Allocate all the DMA buffers for this channel. */
 	ret = sc0710_dma_chains_alloc(ch, ch->buf_size);
 	if (ret < 0) {
@@ -1284,7 +2369,14 @@ int sc0710_dma_channel_alloc(struct sc0710_dev *dev, u32 nr, enum sc0710_channel
 	}
 
 	/* Adjust the descriptor chains to correctly reference each other */
-	sc0710_dma_channel_chains_link(ch);
+	ret = sc0710_dma_channel_chains_link(ch);
+	if (ret < 0) {
+		sc0710_dma_chains_free(ch);
+		ch->enabled = 0;
+		printk(KERN_ERR "%s: channel %d descriptor ring exceeds its page (%d)\n",
+			dev->name, nr, ret);
+		return ret;
+	}
 
 	if (sc0710_debug_mode) {
 		printk(KERN_INFO "%s channel %d allocated\n", dev->name, nr);
@@ -1298,6 +2390,20 @@ int sc0710_dma_channel_alloc(struct sc0710_dev *dev, u32 nr, enum sc0710_channel
 	return 0; /* Success */
 };
 
+static void sc0710_dma_channel_resize_account(struct sc0710_dma_channel *ch,
+	u64 t0, bool recut)
+{
+	u64 ns = ktime_get_ns() - t0;
+
+	if (recut)
+		ch->resize_recut++;
+	else
+		ch->resize_rebuilt++;
+	ch->resize_last_ns = ns;
+	if (ns > ch->resize_max_ns)
+		ch->resize_max_ns = ns;
+}
+
 /* adjust the DMA subsystem transfer_size to match the video frame size
  * we've detected from the HDMI receiver.
  * this is called when the user first asks video streaming to be started,
@@ -1309,6 +2415,7 @@ int sc0710_dma_channel_resize(struct sc0710_dev *dev, u32 nr, enum sc0710_channe
 	enum sc0710_channel_type_e mediatype)
 {
 	struct sc0710_dma_channel *ch = &dev->channel[nr];
+	u64 t0;
 	int ret;
 	if (nr >= SC0710_MAX_CHANNELS)
 		return -EINVAL;
@@ -1323,21 +2430,48 @@ int sc0710_dma_channel_resize(struct sc0710_dev *dev, u32 nr, enum sc0710_channe
 		return 0;
 	}
 
+	t0 = ktime_get_ns();
+
+	/* A frame the ring's allocations can already hold is re-cut over
+	 * them in place: the ring keeps the size of the largest mode it has
+	 * carried, and switching down (4K to 1080p) costs no allocation or
+	 * zeroing. Anything else rebuilds the ring below. */
+	if (ch->mediatype == CHTYPE_VIDEO && ch->pt_cpu) {
+		u32 framesize = sc0710_framesize(dev, dev->fmt);
+		u32 depth = sc0710_dma_channel_depth(ch, framesize, dev->fmt->fpsX100);
+
+		if (sc0710_dma_chains_recut(ch, depth, framesize) == 0) {
+			memset(ch->pt_cpu, 0, ch->pt_size);
+			if (sc0710_dma_channel_chains_link(ch) == 0) {
+				ch->buf_size = framesize;
+				sc0710_dma_channel_resize_account(ch, t0, true);
+				printk(KERN_INFO "%s channel %d re-cut for framesize %d (%d chains)\n",
+					dev->name, nr, framesize, depth);
+				if (sc0710_debug_mode)
+					sc0710_dma_chains_dump(ch);
+				return 0;
+			}
+		}
+	}
+
 	sc0710_dma_chains_free(ch);
 
 	printk(KERN_INFO "%s channel %d resized for framesize %d\n",
 		dev->name, nr, sc0710_framesize(dev, dev->fmt));
 
 	if (ch->mediatype == CHTYPE_VIDEO) {
-		ch->numDescriptorChains = DMA_TRANSFER_CHAINS;
 		/* When processing starts, tear down the current DMA allocations and
 		 * create new DMA allocation sizes suitable for the detect video frame
 		 * size, which could be much larger or smaller than any previous allocation.
-		 * Video transfers vary and need adjustment.
+		 * Video transfers vary and need adjustment; so does the ring
+		 * depth, with the frame rate.
 		 */
 		ch->buf_size = sc0710_framesize(dev, dev->fmt);
+		ch->numDescriptorChains = sc0710_dma_channel_depth(ch, ch->buf_size,
+			dev->fmt->fpsX100);
 		if (sc0710_debug_mode)
-			printk("Resizing channel for size %d\n", ch->buf_size);
+			printk("Resizing channel for size %d, %d chains\n", ch->buf_size,
+				ch->numDescriptorChains);
 	} else
 	if (ch->mediatype == CHTYPE_AUDIO) {
 		/* Audio always uses a fixed transfer size */
@@ -1370,7 +2504,15 @@ int sc0710_dma_channel_resize(struct sc0710_dev *dev, u32 nr, enum sc0710_channe
 		return ret;
 	}
 
-	sc0710_dma_channel_chains_link(ch);
+	ret = sc0710_dma_channel_chains_link(ch);
+	if (ret < 0) {
+		sc0710_dma_chains_free(ch);
+		printk(KERN_ERR "%s: channel %d descriptor ring exceeds its page (%d); channel unusable until the next resize\n",
+			dev->name, nr, ret);
+		return ret;
+	}
+
+	sc0710_dma_channel_resize_account(ch, t0, false);
 
 	if (sc0710_debug_mode) {
 		printk(KERN_INFO "%s channel %d allocated\n", dev->name, nr);
@@ -1383,17 +2525,35 @@ int sc0710_dma_channel_resize(struct sc0710_dev *dev, u32 nr, enum sc0710_channe
 void sc0710_dma_channel_free(struct sc0710_dev *dev, u32 nr)
 {
 	struct sc0710_dma_channel *ch = &dev->channel[nr];
+	int i;
 	if (nr >= SC0710_MAX_CHANNELS)
 		return;
 
-	if (ch->enabled == 0)
+	/* Allocated ahead of everything that can leave the channel disabled. */
+	sc0710_stats_free(&ch->stats);
+
+	if (ch->enabled == 0) {
+		sc0710_dma_pool_free(ch);
+		kfree(ch->chains);
+		ch->chains = NULL;
 		return;
+	}
 
 	ch->enabled = 0;
 
 	/* The V4L2/ALSA nodes are taken down by the remove path before any
 	 * hardware teardown; this frees DMA resources only. */
 	sc0710_dma_chains_free(ch);
+	sc0710_dma_pool_free(ch);
+	kfree(ch->chains);
+	ch->chains = NULL;
+
+	/* The channel was stopped (and its handoff queue flushed) first. */
+	for (i = 0; i < SC0710_HANDOFF_SLOTS; i++) {
+		vfree(ch->handoff[i].buf);
+		ch->handoff[i].buf = NULL;
+		ch->handoff[i].size = 0;
+	}
 
 	if (sc0710_debug_mode)
 		printk(KERN_INFO "%s channel %d deallocated\n", dev->name, nr);
@@ -1431,6 +2591,15 @@ int sc0710_dma_channel_start_prep(struct sc0710_dma_channel *ch)
 	sc_write(ch->dev, 1, ch->register_dma_base + 0x94, 0x00fffe7e);
 
 	ch->dma_completed_descriptor_count_last = 0;
+	ch->ts_desc_done = 0;
+	ch->irq_ts_tail = atomic_read(&ch->irq_ts_head);
+	ch->ts_session_ns = ktime_get_ns();
+	ch->ring_desc_session = 0;
+	ch->ring_laps_session = 0;
+	ch->ring_lost_session = 0;
+	ch->ts_last_ns = 0;
+	ch->ts_period_ns = 0;
+	ch->ts_reject_streak = 0;
 	sc_write(ch->dev, 1, ch->reg_dma_completed_descriptor_count, 0);
 	sc_write(ch->dev, 1, ch->reg_sg_start_h, ch->pt_dma >> 32);
 	sc_write(ch->dev, 1, ch->reg_sg_start_l, ch->pt_dma);
@@ -1492,11 +2661,13 @@ int sc0710_dma_channel_stop(struct sc0710_dma_channel *ch)
 	sc_write(ch->dev, 1, ch->reg_dma_control_w1c, 0x00000001);
 	if (zero_copy && ch->mediatype == CHTYPE_VIDEO)
 		sc0710_dma_channel_quiesce(ch);
-	sc0710_things_per_second_reset(&ch->bitsPerSecond);
-	sc0710_things_per_second_reset(&ch->descPerSecond);
 	ch->state = STATE_STOPPED;
 	ch->dma_last_completion_jiffies = 0;
 	mutex_unlock(&ch->lock);
+
+	/* Frames already handed off still deliver (and re-arm the timer);
+	 * let them finish so the caller's timer_delete_sync() stays final. */
+	sc0710_dma_channel_handoff_flush(ch);
 	return 0;
 }
 
@@ -151,16 +151,16 @@ int sc0710_dma_channels_start(struct sc0710_dev *dev)
 	return 0;
 }
 
-/* Check each dma channel. If writeback metadata suggests a transfer
- * has completed, process it and hand the audio/video to linux
- * subsystems. Returns the number of chain completions consumed.
+/* Check each dma channel of one media type. If writeback metadata
+ * suggests a transfer has completed, process it and hand the audio/video
+ * to linux subsystems. Returns the number of chain completions consumed.
  */
-int sc0710_dma_channels_service(struct sc0710_dev *dev)
+int sc0710_dma_channels_service(struct sc0710_dev *dev, enum sc0710_channel_type_e type)
 {
 	int i, ret, consumed = 0;
 
 	for (i = 0; i < SC0710_MAX_CHANNELS; i++) {
-		if (!dev->channel[i].enabled)
+		if (!dev->channel[i].enabled || dev->channel[i].mediatype != type)
 			continue;
 		ret = sc0710_dma_channel_service(&dev->channel[i]);
 		if (ret > 0)
@@ -30,6 +30,7 @@
 #include <asm/io.h>
 
 #include "sc0710.h"
+#include "sc0710-trace.h"
 
 #define I2C_DEV__ARM_MCU (0x32 << 1)
 #define I2C_DEV__MCU_FN  (0x33 << 1) /* MCU function-call port */
@@ -150,6 +151,7 @@ static int __sc0710_i2c_read_once(struct sc0710_dev *dev, u8 devaddr8bit, u8 *rb
  * failure so stale RX bytes can't offset the next read. */
 static int __sc0710_i2c_read(struct sc0710_dev *dev, u8 devaddr8bit, u8 *rbuf, int rlen)
 {
+	u64 t0 = ktime_get_ns();
 	int ret;
 
 	if (sc0710_i2c_wait_bus_idle(dev) < 0)
@@ -158,6 +160,8 @@ static int __sc0710_i2c_read(struct sc0710_dev *dev, u8 devaddr8bit, u8 *rbuf, i
 		ret = __sc0710_i2c_read_once(dev, devaddr8bit, rbuf, rlen);
 	if (ret < 0)
 		sc0710_i2c_bus_reset(dev);
+	trace_sc0710_i2c_xfer(dev->nr, devaddr8bit, 0, 0, rlen, ret,
+		ktime_get_ns() - t0);
 	return ret;
 }
 
@@ -202,9 +206,12 @@ static int __sc0710_i2c_write_once(struct sc0710_dev *dev, u8 devaddr8bit, u8 *w
  * next transaction starts clean instead of reading the wreckage. */
 static int sc0710_i2c_write(struct sc0710_dev *dev, u8 devaddr8bit, u8 *wbuf, int wlen)
 {
+	u64 t0 = ktime_get_ns();
 	int ret = __sc0710_i2c_write_once(dev, devaddr8bit, wbuf, wlen);
 	if (ret < 0)
 		sc0710_i2c_bus_reset(dev);
+	trace_sc0710_i2c_xfer(dev->nr, devaddr8bit, wlen ? wbuf[0] : 0, wlen, 0,
+		ret, ktime_get_ns() - t0);
 	return ret;
 }
 #endif
@@ -297,9 +304,12 @@ static int __sc0710_i2c_writeread_once(struct sc0710_dev *dev, u8 devaddr8bit, u
  * would offset every subsequent read; reset the engine on any failure. */
 static int __sc0710_i2c_writeread(struct sc0710_dev *dev, u8 devaddr8bit, u8 *wbuf, int wlen, u8 *rbuf, int rlen)
 {
+	u64 t0 = ktime_get_ns();
 	int ret = __sc0710_i2c_writeread_once(dev, devaddr8bit, wbuf, wlen, rbuf, rlen);
 	if (ret < 0)
 		sc0710_i2c_bus_reset(dev);
+	trace_sc0710_i2c_xfer(dev->nr, devaddr8bit, wbuf[0], wlen, rlen, ret,
+		ktime_get_ns() - t0);
 	return ret;
 }
 
@@ -312,6 +322,17 @@ static int sc0710_i2c_writeread(struct sc0710_dev *dev, u8 devaddr8bit, u8 *wbuf
 	return ret;
 }
 
+static void sc0710_resync_account(struct sc0710_dev *dev, u64 t0)
+{
+	u64 ns = ktime_get_ns() - t0;
+
+	dev->resync_count++;
+	dev->resync_sum_ns += ns;
+	dev->resync_last_ns = ns;
+	if (ns > dev->resync_max_ns)
+		dev->resync_max_ns = ns;
+}
+
 /* Atomic DMA restart on signal restoration or resolution/refresh change.
  * Serializes with the DMA service thread via kthread_dma_lock so that
  * dequeue cannot race with stop/resize/start.
@@ -323,8 +344,10 @@ void sc0710_reset_dma_frame_sync(struct sc0710_dev *dev)
 	struct sc0710_dma_descriptor_chain_allocation *dca;
 	int ch_idx, i, j;
 	int retry;
+	int ret;
 	int dma_was_running = 0;
 	int has_streaming_clients = 0;
+	u64 t0 = ktime_get_ns();
 
 	/* Hold the DMA service lock for the entire sequence, including the
 	 * fmt/state/refcount snapshot: STREAMON and STREAMOFF take the same
@@ -363,6 +386,7 @@ void sc0710_reset_dma_frame_sync(struct sc0710_dev *dev)
 		dev->name, dma_was_running ? "running" : "stopped");
 
 	dev->reconfig_in_progress = 1;
+	trace_sc0710_resync(dev->nr, SC0710_RESYNC_BEGIN, dma_was_running);
 
 	/* Phase 1: Stop video DMA channels */
 	if (dma_was_running) {
@@ -379,11 +403,16 @@ void sc0710_reset_dma_frame_sync(struct sc0710_dev *dev)
 
 			printk(KERN_INFO "%s: Stopping DMA channel %d for resync\n",
 				dev->name, ch_idx);
+			trace_sc0710_resync(dev->nr, SC0710_RESYNC_STOP, ch_idx);
 
 			sc_write(dev, 1, ch->reg_dma_control_w1c, 0x00000001);
 
 			usleep_range(5000, 6000);
 
+			/* Deliver what was already handed off before the timer
+			 * goes: the delivery worker re-arms it. */
+			sc0710_dma_channel_handoff_flush(ch);
+
 			timer_delete_sync(&ch->timeout);
 
 			mb();
@@ -415,8 +444,10 @@ void sc0710_reset_dma_frame_sync(struct sc0710_dev *dev)
 	if (zero_copy) {
 		for (ch_idx = 0; ch_idx < SC0710_MAX_CHANNELS; ch_idx++) {
 			ch = &dev->channel[ch_idx];
-			if (ch->enabled && ch->mediatype == CHTYPE_VIDEO)
+			if (ch->enabled && ch->mediatype == CHTYPE_VIDEO) {
 				sc0710_dma_channel_untarget_all(ch);
+				sc0710_dma_channel_zc_rearm(ch);
+			}
 		}
 	}
 
@@ -424,7 +455,9 @@ void sc0710_reset_dma_frame_sync(struct sc0710_dev *dev)
 	 * On failure leave the channels stopped: restarting over a missing ring
 	 * would hand the engine a NULL descriptor pointer. The next timing
 	 * change or STREAMON retries the resize. */
-	if (sc0710_dma_channels_resize(dev) < 0) {
+	ret = sc0710_dma_channels_resize(dev);
+	trace_sc0710_resync(dev->nr, SC0710_RESYNC_RESIZE, ret);
+	if (ret < 0) {
 		printk(KERN_ERR "%s: DMA resize failed during resync; leaving channels stopped\n",
 			dev->name);
 
@@ -447,6 +480,8 @@ void sc0710_reset_dma_frame_sync(struct sc0710_dev *dev)
 		}
 
 		dev->reconfig_in_progress = 0;
+		trace_sc0710_resync(dev->nr, SC0710_RESYNC_FAILED, ret);
+		sc0710_resync_account(dev, t0);
 		mutex_unlock(&dev->kthread_dma_lock);
 		return;
 	}
@@ -463,6 +498,7 @@ void sc0710_reset_dma_frame_sync(struct sc0710_dev *dev)
 			ch->tear_last_line = -1;
 		}
 	}
+	trace_sc0710_resync(dev->nr, SC0710_RESYNC_SKIP, 3);
 
 	/* Phase 4: Full restart via the canonical path (prep, pipeline
 	 * registers, enable, channel start).  This uses the single
@@ -474,6 +510,7 @@ void sc0710_reset_dma_frame_sync(struct sc0710_dev *dev)
 		int dma_running_ok = 1;
 
 		sc0710_dma_channels_start(dev);
+		trace_sc0710_resync(dev->nr, SC0710_RESYNC_RESTART, retry);
 
 		for (ch_idx = 0; ch_idx < SC0710_MAX_CHANNELS; ch_idx++) {
 			u32 dma_ctrl;
@@ -514,6 +551,8 @@ void sc0710_reset_dma_frame_sync(struct sc0710_dev *dev)
 	}
 
 	dev->reconfig_in_progress = 0;
+	trace_sc0710_resync(dev->nr, SC0710_RESYNC_DONE, retry);
+	sc0710_resync_account(dev, t0);
 	mutex_unlock(&dev->kthread_dma_lock);
 
 	printk(KERN_INFO "%s: DMA restarted after signal restoration\n", dev->name);
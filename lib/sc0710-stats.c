@@ -0,0 +1,369 @@
+/*
+ *  Driver for the Elgato 4k60 Pro MK.2 and Elgato 4K Pro HDMI capture cards.
+ *
+ *  Copyright (c) 2021-2022 Steven Toth <stoth@kernellabs.com>
+ *  Modifications Copyright (c) 2025-2026 Nakildias <nakildiaspro@gmail.com>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+/*
+ * Per-channel statistics.
+ *
+ * Counters are per-CPU u64_stats_t under a u64_stats_sync: a writer only
+ * disables preemption and bumps its own CPU's copy, a reader sums every
+ * CPU's copy and retries a copy that changed under it. A per-device
+ * delayed work snapshots the totals once a second into a short history;
+ * a rate over N seconds is the live total minus the snapshot at least N
+ * seconds old, divided by the snapshot's real age. So the only clock
+ * reads are the sampler's and the reader's, none per frame.
+ */
+
+#include <linux/module.h>
+#include <linux/percpu.h>
+#include <linux/u64_stats_sync.h>
+#include <linux/workqueue.h>
+#include <linux/timer.h>
+#include <linux/math64.h>
+#include <linux/sysfs.h>
+
+#include "sc0710.h"
+
+int sc0710_stats_init(struct sc0710_stats *s)
+{
+	int cpu;
+
+	spin_lock_init(&s->hist_lock);
+	s->hist_head = 0;
+	s->hist_count = 0;
+
+	s->pcpu = alloc_percpu(struct sc0710_stats_pcpu);
+	if (!s->pcpu)
+		return -ENOMEM;
+
+	for_each_possible_cpu(cpu)
+		u64_stats_init(&per_cpu_ptr(s->pcpu, cpu)->syncp);
+
+	return 0;
+}
+
+void sc0710_stats_free(struct sc0710_stats *s)
+{
+	free_percpu(s->pcpu);
+	s->pcpu = NULL;
+}
+
+/* Totals across all CPUs, tot[SC0710_STAT_COUNT]. */
+void sc0710_stats_read(struct sc0710_stats *s, u64 *tot)
+{
+	u64 v[SC0710_STAT_COUNT];
+	unsigned int start;
+	int cpu, i;
+
+	memset(tot, 0, sizeof(v));
+	if (!s->pcpu)
+		return;
+
+	for_each_possible_cpu(cpu) {
+		struct sc0710_stats_pcpu *p = per_cpu_ptr(s->pcpu, cpu);
+
+		do {
+			start = u64_stats_fetch_begin(&p->syncp);
+			for (i = 0; i < SC0710_STAT_COUNT; i++)
+				v[i] = u64_stats_read(&p->val[i]);
+		} while (u64_stats_fetch_retry(&p->syncp, start));
+
+		for (i = 0; i < SC0710_STAT_COUNT; i++)
+			tot[i] += v[i];
+	}
+}
+
+/* Totals, and rates in hundredths per second over the last window_s
+ * seconds (less until that much history exists; 0 before the first
+ * sample). */
+void sc0710_stats_rates(struct sc0710_stats *s, u32 window_s, u64 *tot, u64 *rate_x100)
+{
+	u64 then[SC0710_STAT_COUNT];
+	u64 then_ns, dt;
+	u32 back, idx;
+	int i;
+
+	sc0710_stats_read(s, tot);
+	dt = ktime_get_ns();
+	memset(rate_x100, 0, sizeof(then));
+
+	window_s = clamp_t(u32, window_s, 1, SC0710_STATS_MAX_WINDOW);
+
+	spin_lock(&s->hist_lock);
+	if (!s->hist_count) {
+		spin_unlock(&s->hist_lock);
+		return;
+	}
+	/* The newest sample is less than a second old, so the one window_s
+	 * further back is at least window_s old. */
+	back = min_t(u32, window_s + 1, s->hist_count);
+	idx = (s->hist_head + SC0710_STATS_HISTORY - back) % SC0710_STATS_HISTORY;
+	memcpy(then, s->hist[idx], sizeof(then));
+	then_ns = s->hist_ns[idx];
+	spin_unlock(&s->hist_lock);
+
+	dt -= then_ns;
+	if (!dt)
+		return;
+
+	for (i = 0; i < SC0710_STAT_COUNT; i++)
+		rate_x100[i] = mul_u64_u64_div_u64(tot[i] - then[i],
+						   100ULL * NSEC_PER_SEC, dt);
+}
+
+static void sc0710_stats_sample(struct sc0710_stats *s, u64 now)
+{
+	u64 tot[SC0710_STAT_COUNT];
+
+	sc0710_stats_read(s, tot);
+
+	spin_lock(&s->hist_lock);
+	memcpy(s->hist[s->hist_head], tot, sizeof(tot));
+	s->hist_ns[s->hist_head] = now;
+	s->hist_head = (s->hist_head + 1) % SC0710_STATS_HISTORY;
+	if (s->hist_count < SC0710_STATS_HISTORY)
+		s->hist_count++;
+	spin_unlock(&s->hist_lock);
+}
+
+static void sc0710_stats_work(struct work_struct *work)
+{
+	struct sc0710_dev *dev = container_of(to_delayed_work(work),
+					      struct sc0710_dev, stats_work);
+	u64 now = ktime_get_ns();
+	int i;
+
+	for (i = 0; i < SC0710_MAX_CHANNELS; i++) {
+		struct sc0710_dma_channel *ch = &dev->channel[i];
+
+		if (ch->enabled)
+			sc0710_stats_sample(&ch->stats, now);
+	}
+
+	/* Rates divide by the recorded sample times, so rounding the period
+	 * to batch wakeups costs no accuracy. */
+	schedule_delayed_work(&dev->stats_work, round_jiffies_relative(HZ));
+}
+
+/* Once the channels are allocated; the first sample is immediate so the
+ * first read already has a baseline. */
+void sc0710_stats_start(struct sc0710_dev *dev)
+{
+	INIT_DELAYED_WORK(&dev->stats_work, sc0710_stats_work);
+	schedule_delayed_work(&dev->stats_work, 0);
+}
+
+/* Before the channels are freed. */
+void sc0710_stats_stop(struct sc0710_dev *dev)
+{
+	cancel_delayed_work_sync(&dev->stats_work);
+}
+
+/*
+ * sysfs export: /sys/bus/pci/devices/<bdf>/stats/, one decimal value per
+ * file, for monitoring that would otherwise scrape /proc/sc0710-state.
+ * Nothing here takes signalMutex or touches the hardware: counters come
+ * from the per-CPU totals above or single-word fields, and the signal
+ * values from the current format object, which is never rewritten in
+ * place. stats/version is SC0710_STATS_ABI_VERSION; files are only ever
+ * added under one version, a rename, removal or change of meaning bumps
+ * it.
+ */
+
+enum sc0710_stat_attr_e {
+	/* Per channel, beyond the per-CPU counters */
+	SC0710_ATTR_RING_OVERRUNS = SC0710_STAT_COUNT,
+	SC0710_ATTR_HANDOFF_DROPS,
+	SC0710_ATTR_ZC_STALE_EVENTS,
+	SC0710_ATTR_ZC_TRIPPED,
+
+	/* Device */
+	SC0710_ATTR_VERSION,
+	SC0710_ATTR_IRQ_COUNT,
+	SC0710_ATTR_IRQ_MISSED,
+	SC0710_ATTR_IRQ_DEAD,
+	SC0710_ATTR_COMPLETIONS,
+	SC0710_ATTR_SIGNAL_LOCKED,
+	SC0710_ATTR_SIGNAL_WIDTH,
+	SC0710_ATTR_SIGNAL_HEIGHT,
+	SC0710_ATTR_SIGNAL_FPS_X100,
+	SC0710_ATTR_SIGNAL_INTERLACED,
+};
+
+struct sc0710_stat_attr {
+	struct device_attribute attr;
+	u32 ch;
+	u32 id;
+};
+
+static ssize_t sc0710_stat_attr_show(struct device *device,
+	struct device_attribute *attr, char *buf)
+{
+	struct sc0710_stat_attr *sa = container_of(attr, struct sc0710_stat_attr, attr);
+	struct sc0710_dev *dev = pci_get_drvdata(to_pci_dev(device));
+	struct sc0710_dma_channel *ch;
+	const struct sc0710_format *fmt;
+	u64 tot[SC0710_STAT_COUNT];
+	u64 v = 0;
+
+	if (!dev)
+		return -ENODEV;
+
+	if (sa->id < SC0710_ATTR_VERSION) {
+		ch = &dev->channel[sa->ch];
+		if (!ch->enabled)
+			return sysfs_emit(buf, "0\n");
+
+		switch (sa->id) {
+		case SC0710_ATTR_RING_OVERRUNS:
+			v = READ_ONCE(ch->ring_overruns);
+			break;
+		case SC0710_ATTR_HANDOFF_DROPS:
+			v = READ_ONCE(ch->handoff_drops);
+			break;
+		case SC0710_ATTR_ZC_STALE_EVENTS:
+			v = READ_ONCE(ch->zc_stale_events);
+			break;
+		case SC0710_ATTR_ZC_TRIPPED:
+			v = READ_ONCE(ch->zc_stale_trip);
+			break;
+		default:
+			sc0710_stats_read(&ch->stats, tot);
+			v = tot[sa->id];
+			break;
+		}
+		return sysfs_emit(buf, "%llu\n", v);
+	}
+
+	/* The format object is stable while referenced, so the signal
+	 * values always describe one mode; 0 without a locked signal. */
+	fmt = READ_ONCE(dev->locked) ? READ_ONCE(dev->fmt) : NULL;
+
+	switch (sa->id) {
+	case SC0710_ATTR_VERSION:
+		v = SC0710_STATS_ABI_VERSION;
+		break;
+	case SC0710_ATTR_IRQ_COUNT:
+		v = READ_ONCE(dev->irq_count);
+		break;
+	case SC0710_ATTR_IRQ_MISSED:
+		v = READ_ONCE(dev->irq_missed);
+		break;
+	case SC0710_ATTR_IRQ_DEAD:
+		v = READ_ONCE(dev->irq_dead);
+		break;
+	case SC0710_ATTR_COMPLETIONS:
+		v = atomic64_read(&dev->dma_completions);
+		break;
+	case SC0710_ATTR_SIGNAL_LOCKED:
+		v = fmt != NULL;
+		break;
+	case SC0710_ATTR_SIGNAL_WIDTH:
+		v = fmt ? fmt->width : 0;
+		break;
+	case SC0710_ATTR_SIGNAL_HEIGHT:
+		v = fmt ? fmt->height : 0;
+		break;
+	case SC0710_ATTR_SIGNAL_FPS_X100:
+		v = fmt ? fmt->fpsX100 : 0;
+		break;
+	case SC0710_ATTR_SIGNAL_INTERLACED:
+		v = fmt ? fmt->interlaced : 0;
+		break;
+	}
+	return sysfs_emit(buf, "%llu\n", v);
+}
+
+#define SC0710_STAT_ATTR(_name, _ch, _id)				\
+	static struct sc0710_stat_attr sc0710_stat_attr_##_name = {	\
+		.attr = __ATTR(_name, 0444, sc0710_stat_attr_show, NULL),	\
+		.ch = _ch,						\
+		.id = _id,						\
+	}
+
+#define SC0710_CH_STAT_ATTRS(_ch)					\
+	SC0710_STAT_ATTR(ch##_ch##_bytes, _ch, SC0710_STAT_BYTES);	\
+	SC0710_STAT_ATTR(ch##_ch##_frames, _ch, SC0710_STAT_FRAMES);	\
+	SC0710_STAT_ATTR(ch##_ch##_descriptors, _ch, SC0710_STAT_DESCS);	\
+	SC0710_STAT_ATTR(ch##_ch##_drops, _ch, SC0710_STAT_DROPS);	\
+	SC0710_STAT_ATTR(ch##_ch##_copies, _ch, SC0710_STAT_COPIES);	\
+	SC0710_STAT_ATTR(ch##_ch##_zc_hits, _ch, SC0710_STAT_ZC_HITS);	\
+	SC0710_STAT_ATTR(ch##_ch##_samples, _ch, SC0710_STAT_SAMPLES);	\
+	SC0710_STAT_ATTR(ch##_ch##_ring_overruns, _ch, SC0710_ATTR_RING_OVERRUNS); \
+	SC0710_STAT_ATTR(ch##_ch##_handoff_drops, _ch, SC0710_ATTR_HANDOFF_DROPS); \
+	SC0710_STAT_ATTR(ch##_ch##_zc_stale_events, _ch, SC0710_ATTR_ZC_STALE_EVENTS); \
+	SC0710_STAT_ATTR(ch##_ch##_zc_tripped, _ch, SC0710_ATTR_ZC_TRIPPED)
+
+#define SC0710_CH_STAT_ATTR_LIST(_ch)					\
+	&sc0710_stat_attr_ch##_ch##_bytes.attr.attr,			\
+	&sc0710_stat_attr_ch##_ch##_frames.attr.attr,			\
+	&sc0710_stat_attr_ch##_ch##_descriptors.attr.attr,		\
+	&sc0710_stat_attr_ch##_ch##_drops.attr.attr,			\
+	&sc0710_stat_attr_ch##_ch##_copies.attr.attr,			\
+	&sc0710_stat_attr_ch##_ch##_zc_hits.attr.attr,			\
+	&sc0710_stat_attr_ch##_ch##_samples.attr.attr,			\
+	&sc0710_stat_attr_ch##_ch##_ring_overruns.attr.attr,		\
+	&sc0710_stat_attr_ch##_ch##_handoff_drops.attr.attr,		\
+	&sc0710_stat_attr_ch##_ch##_zc_stale_events.attr.attr,		\
+	&sc0710_stat_attr_ch##_ch##_zc_tripped.attr.attr
+
+SC0710_STAT_ATTR(version, 0, SC0710_ATTR_VERSION);
+SC0710_STAT_ATTR(irq_count, 0, SC0710_ATTR_IRQ_COUNT);
+SC0710_STAT_ATTR(irq_missed, 0, SC0710_ATTR_IRQ_MISSED);
+SC0710_STAT_ATTR(irq_dead, 0, SC0710_ATTR_IRQ_DEAD);
+SC0710_STAT_ATTR(completions, 0, SC0710_ATTR_COMPLETIONS);
+SC0710_STAT_ATTR(signal_locked, 0, SC0710_ATTR_SIGNAL_LOCKED);
+SC0710_STAT_ATTR(signal_width, 0, SC0710_ATTR_SIGNAL_WIDTH);
+SC0710_STAT_ATTR(signal_height, 0, SC0710_ATTR_SIGNAL_HEIGHT);
+SC0710_STAT_ATTR(signal_fps_x100, 0, SC0710_ATTR_SIGNAL_FPS_X100);
+SC0710_STAT_ATTR(signal_interlaced, 0, SC0710_ATTR_SIGNAL_INTERLACED);
+SC0710_CH_STAT_ATTRS(0);
+SC0710_CH_STAT_ATTRS(1);
+
+static struct attribute *sc0710_stats_attrs[] = {
+	&sc0710_stat_attr_version.attr.attr,
+	&sc0710_stat_attr_irq_count.attr.attr,
+	&sc0710_stat_attr_irq_missed.attr.attr,
+	&sc0710_stat_attr_irq_dead.attr.attr,
+	&sc0710_stat_attr_completions.attr.attr,
+	&sc0710_stat_attr_signal_locked.attr.attr,
+	&sc0710_stat_attr_signal_width.attr.attr,
+	&sc0710_stat_attr_signal_height.attr.attr,
+	&sc0710_stat_attr_signal_fps_x100.attr.attr,
+	&sc0710_stat_attr_signal_interlaced.attr.attr,
+	SC0710_CH_STAT_ATTR_LIST(0),
+	SC0710_CH_STAT_ATTR_LIST(1),
+	NULL,
+};
+
+static const struct attribute_group sc0710_stats_group = {
+	.name  = "stats",
+	.attrs = sc0710_stats_attrs,
+};
+
+int sc0710_stats_sysfs_add(struct sc0710_dev *dev)
+{
+	return device_add_group(&dev->pci->dev, &sc0710_stats_group);
+}
+
+void sc0710_stats_sysfs_remove(struct sc0710_dev *dev)
+{
+	device_remove_group(&dev->pci->dev, &sc0710_stats_group);
+}
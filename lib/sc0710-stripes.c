@@ -0,0 +1,173 @@
+/*
+ *  Driver for the Elgato 4k60 Pro MK.2 and Elgato 4K Pro HDMI capture cards.
+ *
+ *  Copyright (c) 2021-2022 Steven Toth <stoth@kernellabs.com>
+ *  Modifications Copyright (c) 2025-2026 Nakildias <nakildiaspro@gmail.com>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+/*
+ * Pixel worker pool.
+ *
+ * The host tonemap and the interlaced field weave are per-line passes
+ * over a whole frame, and at 4K they dominate the DMA thread's service
+ * time. Each device gets an unbound, high-priority workqueue capped at
+ * px_workers concurrent items; a pass is cut into that many horizontal
+ * stripes, the DMA thread queues one work item per stripe and sleeps
+ * until the last one completes. Stripe callbacks must only touch their
+ * own rows (and their own slot of any per-stripe result).
+ *
+ * With one worker, or a frame too short to be worth cutting, the pass
+ * runs inline on the calling thread exactly as before the pool existed.
+ */
+
+#include <linux/module.h>
+#include <linux/workqueue.h>
+#include <linux/completion.h>
+#include <linux/ktime.h>
+#include <linux/cpumask.h>
+
+#include "sc0710.h"
+
+/* Below this many rows per stripe, queueing costs more than it saves. */
+#define SC0710_PX_MIN_ROWS 32
+
+#define dprintk(level, fmt, arg...)\
+	do { if (sc0710_debug_mode >= level)\
+		printk(KERN_DEBUG "%s: " fmt, dev->name, ## arg);\
+	} while (0)
+
+static void sc0710_px_stripe_account(struct sc0710_px_stripe *s, u64 ns)
+{
+	struct sc0710_px_pool *pool = s->pool;
+
+	spin_lock(&pool->stats_lock);
+	s->runs++;
+	s->last_ns = ns;
+	s->total_ns += ns;
+	if (ns > s->max_ns)
+		s->max_ns = ns;
+	spin_unlock(&pool->stats_lock);
+}
+
+static void sc0710_px_work(struct work_struct *work)
+{
+	struct sc0710_px_stripe *s = container_of(work, struct sc0710_px_stripe, work);
+	struct sc0710_px_pool *pool = s->pool;
+	u64 t0 = ktime_get_ns();
+
+	pool->fn(pool->arg, s->y0, s->y1, s->idx);
+	sc0710_px_stripe_account(s, ktime_get_ns() - t0);
+
+	if (atomic_dec_and_test(&pool->pending))
+		complete(&pool->done);
+}
+
+/* Run fn over rows [0, rows) in stripes and return once every stripe is
+ * done. Sleeps; never call it under a spinlock. */
+void sc0710_px_run(struct sc0710_dev *dev, u32 rows, sc0710_px_fn fn, void *arg)
+{
+	struct sc0710_px_pool *pool = &dev->px;
+	u32 nr = pool->workers;
+	u64 t0;
+	u32 i;
+
+	if (!rows)
+		return;
+
+	if (nr > rows / SC0710_PX_MIN_ROWS)
+		nr = rows / SC0710_PX_MIN_ROWS;
+
+	if (!pool->wq || nr <= 1) {
+		t0 = ktime_get_ns();
+		fn(arg, 0, rows, 0);
+		sc0710_px_stripe_account(&pool->stripe[0], ktime_get_ns() - t0);
+		return;
+	}
+
+	mutex_lock(&pool->lock);
+	t0 = ktime_get_ns();
+
+	pool->fn = fn;
+	pool->arg = arg;
+	reinit_completion(&pool->done);
+	atomic_set(&pool->pending, nr);
+
+	for (i = 0; i < nr; i++) {
+		struct sc0710_px_stripe *s = &pool->stripe[i];
+
+		s->y0 = (u32)div_u64((u64)rows * i, nr);
+		s->y1 = (u32)div_u64((u64)rows * (i + 1), nr);
+		queue_work(pool->wq, &s->work);
+	}
+
+	wait_for_completion(&pool->done);
+
+	pool->wall_last_ns = ktime_get_ns() - t0;
+	pool->wall_total_ns += pool->wall_last_ns;
+	if (pool->wall_last_ns > pool->wall_max_ns)
+		pool->wall_max_ns = pool->wall_last_ns;
+	pool->dispatches++;
+	mutex_unlock(&pool->lock);
+}
+
+void sc0710_px_pool_init(struct sc0710_dev *dev)
+{
+	struct sc0710_px_pool *pool = &dev->px;
+	u32 workers = px_workers;
+	int i;
+
+	mutex_init(&pool->lock);
+	spin_lock_init(&pool->stats_lock);
+	init_completion(&pool->done);
+	atomic_set(&pool->pending, 0);
+	for (i = 0; i < SC0710_PX_MAX_STRIPES; i++) {
+		pool->stripe[i].pool = pool;
+		pool->stripe[i].idx = i;
+		INIT_WORK(&pool->stripe[i].work, sc0710_px_work);
+	}
+
+	/* 0 = auto: half the online CPUs, leaving the rest to the capture
+	 * application and the encoder downstream of it. */
+	if (workers == 0)
+		workers = clamp_t(u32, num_online_cpus() / 2, 1, 8);
+	pool->workers = min_t(u32, workers, SC0710_PX_MAX_STRIPES);
+
+	if (pool->workers <= 1)
+		return;
+
+	pool->wq = alloc_workqueue("sc0710-px/%d", WQ_UNBOUND | WQ_HIGHPRI,
+				   pool->workers, dev->nr);
+	if (!pool->wq) {
+		printk(KERN_WARNING "%s: pixel worker pool unavailable, processing frames on the DMA thread\n",
+			dev->name);
+		pool->workers = 1;
+		return;
+	}
+
+	dprintk(1, "%s() %u pixel workers\n", __func__, pool->workers);
+}
+
+/* After the DMA thread has stopped: nothing can dispatch any more. */
+void sc0710_px_pool_free(struct sc0710_dev *dev)
+{
+	struct sc0710_px_pool *pool = &dev->px;
+
+	if (pool->wq) {
+		destroy_workqueue(pool->wq);
+		pool->wq = NULL;
+	}
+}
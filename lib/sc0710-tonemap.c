@@ -3,6 +3,7 @@
  *
  * BGR24: luminance-preserving map. Defaults tm_bgr_*=50/400/150/150 (live).
  *        Baked gold path (T=0.58 / paper 203) still used when knobs match those.
+ *        tm_bgr_lut=1 (default) applies it through bit-exact cached tables.
  * YUYV:  live Reinhard on limited Y'. Defaults tm_yuyv_*=80/225/100/300.
  *
  * Curve LUTs: scripts/gen-tonemap-luts.py (BGR24 baked at paper 203 / T=0.58).
@@ -10,6 +11,9 @@
 
 #include <linux/types.h>
 #include <linux/kernel.h>
+#include <linux/unaligned.h>
+#include <linux/atomic.h>
+#include <linux/mutex.h>
 #include "sc0710.h"
 #include "sc0710-tonemap-luts.h"
 
@@ -189,31 +193,196 @@ static void sc0710_tm_rgb_pq_pixel_live(u8 *b, u8 *g, u8 *r,
 	*r = sc0710_tm_apply_u8_gain(sc0710_tm_lin_q16_to_srgb((u32)ro), gain);
 }
 
+/* Clamped tm_bgr_* knobs a BGR24 frame (or its cached tables) was built from. */
+struct sc0710_tm_bgr_knobs {
+	int target;
+	int paper;
+	int gain;
+	int chroma;
+	bool use_baked;
+};
+
+static void sc0710_tm_bgr_knobs_read(struct sc0710_tm_bgr_knobs *k)
+{
+	k->target = sc0710_tm_clamp_int(tm_bgr_target, 1, 100);
+	k->paper = sc0710_tm_clamp_int(tm_bgr_paper, 1, 10000);
+	k->gain = sc0710_tm_clamp_int(tm_bgr_gain, 1, 200);
+	k->chroma = sc0710_tm_clamp_int(tm_bgr_chroma, 0, 300);
+	/* Gold defaults from gen-tonemap-luts.py / sc0710-software-hdr. */
+	k->use_baked = (k->target == 58 && k->paper == SC0710_TM_PAPER_NITS);
+}
+
+static inline void sc0710_tm_bgr_pixel(u8 *b, u8 *g, u8 *r,
+				       const struct sc0710_tm_bgr_knobs *k)
+{
+	if (k->use_baked)
+		sc0710_tm_rgb_pq_pixel_baked(b, g, r, k->gain);
+	else
+		sc0710_tm_rgb_pq_pixel_live(b, g, r, k->target, k->paper,
+					    k->gain);
+	sc0710_tm_apply_sat_u8(b, g, r, k->chroma);
+}
+
+/*
+ * BGR24 cached tables. The curve couples the channels only through the
+ * whole-nits luma: a pixel's output is its three codes' linear light
+ * relative to paper white (per-code table), scaled by the Reinhard ratio
+ * of its truncated luma (per-luma table), sRGB-encoded with the gain
+ * folded in (per-index table), then saturated (per-difference table).
+ * The tables are filled with the per-pixel paths' own arithmetic, so the
+ * result is bit-exact while the six divides per pixel go away. Like the
+ * YUYV tables they are shared by every device and rebuilt lazily once the
+ * tm_bgr_* setters bump sc0710_tm_bgr_gen; scripts/tm-bgr-lut-error.c
+ * checks them against the per-pixel curve over all 2^24 inputs.
+ */
+#define SC0710_TM_BGR_MAX_NITS	10000
+
+static struct {
+	u32 rel[256];				/* channel nits / paper, Q16 */
+	u32 scale[SC0710_TM_BGR_MAX_NITS + 1];	/* Q16, by whole-nits luma */
+	u8 out[1024];				/* sRGB code, gain applied */
+	s16 sat[511];				/* (d · chroma) / 100, d = -255..255 */
+	struct sc0710_tm_bgr_knobs knobs;
+	int gen;
+} sc0710_tm_bgr_cache = { .gen = -1 };
+static atomic_t sc0710_tm_bgr_gen = ATOMIC_INIT(0);
+static DEFINE_MUTEX(sc0710_tm_bgr_lock);
+
+void sc0710_tm_bgr_knobs_changed(void)
+{
+	atomic_inc(&sc0710_tm_bgr_gen);
+}
+
+/* Reinhard scale for a whole-nits luma, as the per-pixel paths derive it. */
+static u32 sc0710_tm_bgr_scale(u32 y_nits, const struct sc0710_tm_bgr_knobs *k)
+{
+	u32 y_out_q16, y_rel_q16, scale_q16;
+	int den;
+
+	if (k->use_baked) {
+		if (y_nits > 4095)
+			y_nits = 4095;
+		y_out_q16 = sc0710_tm_nits_to_lin_q16[y_nits];
+		y_rel_q16 = (y_nits << 16) / SC0710_TM_PAPER_NITS;
+	} else {
+		den = (int)y_nits + k->paper;
+		y_out_q16 = (u32)(((u64)2 * k->target * y_nits * 65535ull) /
+				  ((u64)100 * den));
+		if (y_out_q16 > 65535)
+			y_out_q16 = 65535;
+		y_rel_q16 = (y_nits << 16) / (u32)k->paper;
+	}
+	if (y_rel_q16 == 0)
+		y_rel_q16 = 1;
+	scale_q16 = (u32)(((u64)y_out_q16 << 16) / y_rel_q16);
+	if (scale_q16 > 0x30000)
+		scale_q16 = 0x30000;
+	return scale_q16;
+}
+
+static void sc0710_tm_bgr_rebuild(int gen)
+{
+	struct sc0710_tm_bgr_knobs *k = &sc0710_tm_bgr_cache.knobs;
+	u32 paper;
+	int i;
+
+	sc0710_tm_bgr_knobs_read(k);
+	paper = k->use_baked ? SC0710_TM_PAPER_NITS : (u32)k->paper;
+
+	for (i = 0; i < 256; i++)
+		sc0710_tm_bgr_cache.rel[i] =
+			((sc0710_tm_pq_to_nits_q12[i] >> 12) << 16) / paper;
+	for (i = 0; i <= SC0710_TM_BGR_MAX_NITS; i++)
+		sc0710_tm_bgr_cache.scale[i] = sc0710_tm_bgr_scale(i, k);
+	for (i = 0; i < 1024; i++)
+		sc0710_tm_bgr_cache.out[i] = sc0710_tm_apply_u8_gain(
+			sc0710_tm_lin_q10_to_srgb[i], k->gain);
+	for (i = -255; i <= 255; i++)
+		sc0710_tm_bgr_cache.sat[i + 255] = (i * k->chroma) / 100;
+
+	/* Tables before generation, as for the YUYV tables. */
+	smp_store_release(&sc0710_tm_bgr_cache.gen, gen);
+}
+
+static inline u8 sc0710_tm_bgr_sat_u8(int c, int y)
+{
+	return (u8)sc0710_tm_clamp_int(y + sc0710_tm_bgr_cache.sat[c - y + 255],
+				       0, 255);
+}
+
+static void sc0710_tm_bgr_lut_apply(u8 *bgr, size_t n)
+{
+	const u32 *rel = sc0710_tm_bgr_cache.rel;
+	const u8 *out = sc0710_tm_bgr_cache.out;
+	bool sat = sc0710_tm_bgr_cache.knobs.chroma != 100;
+	u32 y_nits, scale;
+	u64 bo, go, ro;
+	int b, g, r, y;
+	size_t i;
+
+	for (i = 0; i + 2 < n; i += 3) {
+		b = bgr[i];
+		g = bgr[i + 1];
+		r = bgr[i + 2];
+
+		y_nits = (u32)((689ull * sc0710_tm_pq_to_nits_q12[r] +
+				1778ull * sc0710_tm_pq_to_nits_q12[g] +
+				155ull * sc0710_tm_pq_to_nits_q12[b]) >> 24);
+		if (y_nits == 0) {
+			bgr[i] = bgr[i + 1] = bgr[i + 2] = 0;
+			continue;
+		}
+		if (y_nits > SC0710_TM_BGR_MAX_NITS)
+			y_nits = SC0710_TM_BGR_MAX_NITS;
+		scale = sc0710_tm_bgr_cache.scale[y_nits];
+
+		bo = ((u64)rel[b] * scale) >> 16;
+		go = ((u64)rel[g] * scale) >> 16;
+		ro = ((u64)rel[r] * scale) >> 16;
+		b = out[bo > 65535 ? 1023 : bo >> 6];
+		g = out[go > 65535 ? 1023 : go >> 6];
+		r = out[ro > 65535 ? 1023 : ro >> 6];
+
+		if (sat) {
+			/* Y ≈ (54·R + 183·G + 19·B) / 256, as sc0710_tm_apply_sat_u8 */
+			y = (19 * b + 183 * g + 54 * r) >> 8;
+			b = sc0710_tm_bgr_sat_u8(b, y);
+			g = sc0710_tm_bgr_sat_u8(g, y);
+			r = sc0710_tm_bgr_sat_u8(r, y);
+		}
+		bgr[i] = (u8)b;
+		bgr[i + 1] = (u8)g;
+		bgr[i + 2] = (u8)r;
+	}
+}
+
 void sc0710_bgr24_sw_tonemap(u8 *bgr, u32 w, u32 h)
 {
+	struct sc0710_tm_bgr_knobs k;
 	size_t i, n;
-	int target = sc0710_tm_clamp_int(tm_bgr_target, 1, 100);
-	int paper = sc0710_tm_clamp_int(tm_bgr_paper, 1, 10000);
-	int gain = sc0710_tm_clamp_int(tm_bgr_gain, 1, 200);
-	int chroma = sc0710_tm_clamp_int(tm_bgr_chroma, 0, 300);
-	/* Gold defaults from gen-tonemap-luts.py / sc0710-software-hdr. */
-	bool use_baked = (target == 58 && paper == SC0710_TM_PAPER_NITS);
+	int gen;
 
 	if (!bgr || !w || !h)
 		return;
 
 	n = (size_t)w * h * 3;
-	for (i = 0; i + 2 < n; i += 3) {
-		if (use_baked)
-			sc0710_tm_rgb_pq_pixel_baked(&bgr[i], &bgr[i + 1],
-						     &bgr[i + 2], gain);
-		else
-			sc0710_tm_rgb_pq_pixel_live(&bgr[i], &bgr[i + 1],
-						    &bgr[i + 2], target, paper,
-						    gain);
-		sc0710_tm_apply_sat_u8(&bgr[i], &bgr[i + 1], &bgr[i + 2],
-				       chroma);
+
+	if (tm_bgr_lut) {
+		gen = atomic_read(&sc0710_tm_bgr_gen);
+		if (smp_load_acquire(&sc0710_tm_bgr_cache.gen) != gen) {
+			mutex_lock(&sc0710_tm_bgr_lock);
+			gen = atomic_read(&sc0710_tm_bgr_gen);
+			if (sc0710_tm_bgr_cache.gen != gen)
+				sc0710_tm_bgr_rebuild(gen);
+			mutex_unlock(&sc0710_tm_bgr_lock);
+		}
+		sc0710_tm_bgr_lut_apply(bgr, n);
+		return;
 	}
+
+	sc0710_tm_bgr_knobs_read(&k);
+	for (i = 0; i + 2 < n; i += 3)
+		sc0710_tm_bgr_pixel(&bgr[i], &bgr[i + 1], &bgr[i + 2], &k);
 }
 
 /*
@@ -267,13 +436,73 @@ static u8 sc0710_tm_yuyv_map_y(int y, int target, int paper, int gain,
 	return (u8)out;
 }
 
+static inline u8 sc0710_tm_chroma_u8(int c, int scale)
+{
+	int out = 128 + (((c - 128) * scale) >> 8);
+
+	if (out < 0)
+		out = 0;
+	else if (out > 255)
+		out = 255;
+	return (u8)out;
+}
+
 /*
- * YUYV is limited-range PQ Y'CbCr from the card.
- * Knobs are live via /sys/module/sc0710/parameters/tm_* or sc0710-hdr-config.
+ * Apply per-byte-position tables to a YUYV run, one 64-bit word (two
+ * Y0 U Y1 V groups) per step. Every output byte depends only on its own
+ * input byte, so table lookups are bit-exact with the per-sample path and
+ * need no divides or clamps in the loop.
  */
-void sc0710_yuyv8_sw_tonemap(u8 *yuyv, u32 w, u32 h)
+static void sc0710_tm_yuyv_apply(u8 *yuyv, size_t n, const u8 *ylut,
+				 const u8 *ulut, const u8 *vlut)
+{
+	size_t i;
+
+	for (i = 0; i + 7 < n; i += 8) {
+		u64 in = get_unaligned_le64(yuyv + i);
+		u64 out;
+
+		out  = (u64)ylut[in & 0xff];
+		out |= (u64)ulut[(in >> 8) & 0xff] << 8;
+		out |= (u64)ylut[(in >> 16) & 0xff] << 16;
+		out |= (u64)vlut[(in >> 24) & 0xff] << 24;
+		out |= (u64)ylut[(in >> 32) & 0xff] << 32;
+		out |= (u64)ulut[(in >> 40) & 0xff] << 40;
+		out |= (u64)ylut[(in >> 48) & 0xff] << 48;
+		out |= (u64)vlut[in >> 56] << 56;
+		put_unaligned_le64(out, yuyv + i);
+	}
+	for (; i + 3 < n; i += 4) {
+		yuyv[i]     = ylut[yuyv[i]];
+		yuyv[i + 1] = ulut[yuyv[i + 1]];
+		yuyv[i + 2] = ylut[yuyv[i + 2]];
+		yuyv[i + 3] = vlut[yuyv[i + 3]];
+	}
+}
+
+/*
+ * YUYV curve tables, shared by every device. Rebuilt lazily when the
+ * tm_yuyv_* / tm_paper_nits setters have bumped sc0710_tm_yuyv_gen since
+ * the last build; the rebuild mutex keeps concurrent DMA threads from
+ * rebuilding twice. A frame tonemapped while another thread rebuilds may
+ * mix old and new curve entries - a one-frame artifact of a knob write.
+ */
+static struct {
+	u8  y[256];
+	u8  u[256];
+	u8  v[256];
+	int gen;
+} sc0710_tm_yuyv_cache = { .gen = -1 };
+static atomic_t sc0710_tm_yuyv_gen = ATOMIC_INIT(0);
+static DEFINE_MUTEX(sc0710_tm_yuyv_lock);
+
+void sc0710_tm_yuyv_knobs_changed(void)
+{
+	atomic_inc(&sc0710_tm_yuyv_gen);
+}
+
+static void sc0710_tm_yuyv_rebuild(int gen)
 {
-	size_t i, n;
 	int target = sc0710_tm_clamp_int(tm_yuyv_target, 1, 100);
 	int paper = sc0710_tm_clamp_int(tm_paper_nits, 1, 10000);
 	int gain = sc0710_tm_clamp_int(tm_yuyv_gain, 1, 200);
@@ -286,34 +515,46 @@ void sc0710_yuyv8_sw_tonemap(u8 *yuyv, u32 w, u32 h)
 	int white = sc0710_tm_clamp_int(tm_yuyv_white, 180, 235);
 	int uscale = (chroma * u_pct * 256) / 10000;
 	int vscale = (chroma * v_pct * 256) / 10000;
+	int c;
 
-	if (!yuyv || w < 2 || !h)
-		return;
 	if (black > white)
 		black = white;
 
-	n = (size_t)w * h * 2;
-	for (i = 0; i + 3 < n; i += 4) {
-		int u = yuyv[i + 1];
-		int v = yuyv[i + 3];
-		int uo, vo;
-
-		yuyv[i] = sc0710_tm_yuyv_map_y(yuyv[i], target, paper, gain,
-					       black, white, pq_bias, oetf);
-		yuyv[i + 2] = sc0710_tm_yuyv_map_y(yuyv[i + 2], target, paper,
-						   gain, black, white, pq_bias,
-						   oetf);
-		uo = 128 + (((u - 128) * uscale) >> 8);
-		vo = 128 + (((v - 128) * vscale) >> 8);
-		if (uo < 0)
-			uo = 0;
-		else if (uo > 255)
-			uo = 255;
-		if (vo < 0)
-			vo = 0;
-		else if (vo > 255)
-			vo = 255;
-		yuyv[i + 1] = (u8)uo;
-		yuyv[i + 3] = (u8)vo;
+	for (c = 0; c < 256; c++) {
+		sc0710_tm_yuyv_cache.y[c] = sc0710_tm_yuyv_map_y(c, target,
+			paper, gain, black, white, pq_bias, oetf);
+		sc0710_tm_yuyv_cache.u[c] = sc0710_tm_chroma_u8(c, uscale);
+		sc0710_tm_yuyv_cache.v[c] = sc0710_tm_chroma_u8(c, vscale);
 	}
+	/* Tables before generation: a reader seeing the new generation
+	 * must see the tables it describes. */
+	smp_store_release(&sc0710_tm_yuyv_cache.gen, gen);
+}
+
+/*
+ * YUYV is limited-range PQ Y'CbCr from the card.
+ * Knobs are live via /sys/module/sc0710/parameters/tm_* or sc0710-hdr-config.
+ * The curve is a function of the 8-bit input code alone, so it lives in
+ * cached per-code tables and the frame is table-mapped.
+ */
+void sc0710_yuyv8_sw_tonemap(u8 *yuyv, u32 w, u32 h)
+{
+	int gen;
+
+	if (!yuyv || w < 2 || !h)
+		return;
+
+	gen = atomic_read(&sc0710_tm_yuyv_gen);
+	if (smp_load_acquire(&sc0710_tm_yuyv_cache.gen) != gen) {
+		mutex_lock(&sc0710_tm_yuyv_lock);
+		/* Re-read under the lock: the knobs may have moved again,
+		 * or another thread may have rebuilt already. */
+		gen = atomic_read(&sc0710_tm_yuyv_gen);
+		if (sc0710_tm_yuyv_cache.gen != gen)
+			sc0710_tm_yuyv_rebuild(gen);
+		mutex_unlock(&sc0710_tm_yuyv_lock);
+	}
+
+	sc0710_tm_yuyv_apply(yuyv, (size_t)w * h * 2, sc0710_tm_yuyv_cache.y,
+			     sc0710_tm_yuyv_cache.u, sc0710_tm_yuyv_cache.v);
 }
@@ -0,0 +1,210 @@
+/*
+ *  Driver for the Elgato 4k60 Pro MK.2 and Elgato 4K Pro HDMI capture cards.
+ *
+ *  Copyright (c) 2021-2022 Steven Toth <stoth@kernellabs.com>
+ *  Modifications Copyright (c) 2025-2026 Nakildias <nakildiaspro@gmail.com>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+/*
+ * Tracepoints (trace system "sc0710"): DMA chain completions, client
+ * deliveries, zero-copy retargets and stale trips, the DMA resync phases
+ * and MCU I2C transactions. A disabled tracepoint is a patched-out branch,
+ * so unlike the sc0710_debug_mode printks these can stay compiled in on a
+ * live stream:
+ *
+ *   echo 1 > /sys/kernel/tracing/events/sc0710/enable
+ *
+ * Events carry the device number (dev->nr) so several cards can be told
+ * apart. sc0710-core.c instantiates them (CREATE_TRACE_POINTS).
+ */
+
+#undef TRACE_SYSTEM
+#define TRACE_SYSTEM sc0710
+
+#if !defined(_SC0710_TRACE_H) || defined(TRACE_HEADER_MULTI_READ)
+#define _SC0710_TRACE_H
+
+#include <linux/tracepoint.h>
+
+TRACE_EVENT(sc0710_chain_complete,
+	TP_PROTO(u32 nr, u32 ch, u32 chain, u32 wbm0, u32 wbm1, bool stale),
+	TP_ARGS(nr, ch, chain, wbm0, wbm1, stale),
+	TP_STRUCT__entry(
+		__field(u32, nr)
+		__field(u32, ch)
+		__field(u32, chain)
+		__field(u32, wbm0)
+		__field(u32, wbm1)
+		__field(bool, stale)
+	),
+	TP_fast_assign(
+		__entry->nr = nr;
+		__entry->ch = ch;
+		__entry->chain = chain;
+		__entry->wbm0 = wbm0;
+		__entry->wbm1 = wbm1;
+		__entry->stale = stale;
+	),
+	TP_printk("sc0710[%u] ch%u chain %u wbm %08x %08x%s",
+		__entry->nr, __entry->ch, __entry->chain,
+		__entry->wbm0, __entry->wbm1,
+		__entry->stale ? " (retired half)" : "")
+);
+
+TRACE_EVENT(sc0710_buffer_done,
+	TP_PROTO(u32 nr, u32 ch, const void *client, u32 index, u32 sequence,
+		u64 ts_ns, u32 bytes, bool direct),
+	TP_ARGS(nr, ch, client, index, sequence, ts_ns, bytes, direct),
+	TP_STRUCT__entry(
+		__field(u32, nr)
+		__field(u32, ch)
+		__field(const void *, client)
+		__field(u32, index)
+		__field(u32, sequence)
+		__field(u64, ts_ns)
+		__field(u32, bytes)
+		__field(bool, direct)
+	),
+	TP_fast_assign(
+		__entry->nr = nr;
+		__entry->ch = ch;
+		__entry->client = client;
+		__entry->index = index;
+		__entry->sequence = sequence;
+		__entry->ts_ns = ts_ns;
+		__entry->bytes = bytes;
+		__entry->direct = direct;
+	),
+	TP_printk("sc0710[%u] ch%u client %p buf %u seq %u ts %llu bytes %u %s",
+		__entry->nr, __entry->ch, __entry->client, __entry->index,
+		__entry->sequence, __entry->ts_ns, __entry->bytes,
+		__entry->direct ? "direct" : "copied")
+);
+
+TRACE_EVENT(sc0710_zc_retarget,
+	TP_PROTO(u32 nr, u32 ch, u32 chain, u32 index, u32 nsegs),
+	TP_ARGS(nr, ch, chain, index, nsegs),
+	TP_STRUCT__entry(
+		__field(u32, nr)
+		__field(u32, ch)
+		__field(u32, chain)
+		__field(u32, index)
+		__field(u32, nsegs)
+	),
+	TP_fast_assign(
+		__entry->nr = nr;
+		__entry->ch = ch;
+		__entry->chain = chain;
+		__entry->index = index;
+		__entry->nsegs = nsegs;
+	),
+	TP_printk("sc0710[%u] ch%u chain %u -> buf %u (%u segments)",
+		__entry->nr, __entry->ch, __entry->chain, __entry->index,
+		__entry->nsegs)
+);
+
+TRACE_EVENT(sc0710_zc_stale,
+	TP_PROTO(u32 nr, u32 ch, u32 chain, u32 stale_descs, bool trip),
+	TP_ARGS(nr, ch, chain, stale_descs, trip),
+	TP_STRUCT__entry(
+		__field(u32, nr)
+		__field(u32, ch)
+		__field(u32, chain)
+		__field(u32, stale_descs)
+		__field(bool, trip)
+	),
+	TP_fast_assign(
+		__entry->nr = nr;
+		__entry->ch = ch;
+		__entry->chain = chain;
+		__entry->stale_descs = stale_descs;
+		__entry->trip = trip;
+	),
+	TP_printk("sc0710[%u] ch%u chain %u stale descriptors %u%s",
+		__entry->nr, __entry->ch, __entry->chain, __entry->stale_descs,
+		__entry->trip ? " - zero-copy tripped" : "")
+);
+
+#define SC0710_RESYNC_BEGIN	0
+#define SC0710_RESYNC_STOP	1
+#define SC0710_RESYNC_RESIZE	2
+#define SC0710_RESYNC_SKIP	3
+#define SC0710_RESYNC_RESTART	4
+#define SC0710_RESYNC_DONE	5
+#define SC0710_RESYNC_FAILED	6
+
+TRACE_EVENT(sc0710_resync,
+	TP_PROTO(u32 nr, int phase, int arg),
+	TP_ARGS(nr, phase, arg),
+	TP_STRUCT__entry(
+		__field(u32, nr)
+		__field(int, phase)
+		__field(int, arg)
+	),
+	TP_fast_assign(
+		__entry->nr = nr;
+		__entry->phase = phase;
+		__entry->arg = arg;
+	),
+	TP_printk("sc0710[%u] resync %s %d", __entry->nr,
+		__print_symbolic(__entry->phase,
+			{ SC0710_RESYNC_BEGIN,   "begin" },
+			{ SC0710_RESYNC_STOP,    "stop-channel" },
+			{ SC0710_RESYNC_RESIZE,  "resize" },
+			{ SC0710_RESYNC_SKIP,    "arm-skip" },
+			{ SC0710_RESYNC_RESTART, "restart" },
+			{ SC0710_RESYNC_DONE,    "done" },
+			{ SC0710_RESYNC_FAILED,  "failed" }),
+		__entry->arg)
+);
+
+TRACE_EVENT(sc0710_i2c_xfer,
+	TP_PROTO(u32 nr, u8 addr, u8 subaddr, int wlen, int rlen, int ret,
+		u64 duration_ns),
+	TP_ARGS(nr, addr, subaddr, wlen, rlen, ret, duration_ns),
+	TP_STRUCT__entry(
+		__field(u32, nr)
+		__field(u8, addr)
+		__field(u8, subaddr)
+		__field(int, wlen)
+		__field(int, rlen)
+		__field(int, ret)
+		__field(u64, duration_ns)
+	),
+	TP_fast_assign(
+		__entry->nr = nr;
+		__entry->addr = addr;
+		__entry->subaddr = subaddr;
+		__entry->wlen = wlen;
+		__entry->rlen = rlen;
+		__entry->ret = ret;
+		__entry->duration_ns = duration_ns;
+	),
+	TP_printk("sc0710[%u] i2c 0x%02x sub 0x%02x w %d r %d ret %d %llu ns",
+		__entry->nr, __entry->addr, __entry->subaddr, __entry->wlen,
+		__entry->rlen, __entry->ret, __entry->duration_ns)
+);
+
+#endif /* _SC0710_TRACE_H */
+
+/* Out-of-tree: the Makefile puts lib/ on the include path of the file
+ * that defines CREATE_TRACE_POINTS. */
+#undef TRACE_INCLUDE_PATH
+#define TRACE_INCLUDE_PATH .
+#undef TRACE_INCLUDE_FILE
+#define TRACE_INCLUDE_FILE sc0710-trace
+#include <trace/define_trace.h>
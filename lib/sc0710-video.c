@@ -132,54 +132,69 @@ MODULE_PARM_DESC(sw_tonemap,
 /*
  * YUYV host-tonemap fine-tune (sc0710-hdr-config).
  * Defaults: T=0.80, paper 225, gain 100%, sat 300%.
+ * Writes invalidate the tonemap's cached curve tables.
  */
+static int sc0710_param_set_tm_yuyv(const char *val,
+				    const struct kernel_param *kp)
+{
+	int ret = param_set_int(val, kp);
+
+	if (!ret)
+		sc0710_tm_yuyv_knobs_changed();
+	return ret;
+}
+static const struct kernel_param_ops sc0710_tm_yuyv_ops = {
+	.set = sc0710_param_set_tm_yuyv,
+	.get = param_get_int,
+};
+
 int tm_yuyv_target = 80;
-module_param(tm_yuyv_target, int, 0644);
+module_param_cb(tm_yuyv_target, &sc0710_tm_yuyv_ops, &tm_yuyv_target, 0644);
 MODULE_PARM_DESC(tm_yuyv_target,
 	"YUYV Reinhard target T×100 (10-80, default 80). Higher = brighter midtones.");
 
 int tm_paper_nits = 225;
-module_param(tm_paper_nits, int, 0644);
+module_param_cb(tm_paper_nits, &sc0710_tm_yuyv_ops, &tm_paper_nits, 0644);
 MODULE_PARM_DESC(tm_paper_nits,
 	"YUYV tonemap paper-white nits (50-400, default 225). Higher = dimmer highlights.");
 
 int tm_yuyv_gain = 100;
-module_param(tm_yuyv_gain, int, 0644);
+module_param_cb(tm_yuyv_gain, &sc0710_tm_yuyv_ops, &tm_yuyv_gain, 0644);
 MODULE_PARM_DESC(tm_yuyv_gain,
 	"YUYV post-tonemap Y gain percent (50-150, default 100).");
 
 int tm_yuyv_chroma = 300;
-module_param(tm_yuyv_chroma, int, 0644);
+module_param_cb(tm_yuyv_chroma, &sc0710_tm_yuyv_ops, &tm_yuyv_chroma, 0644);
 MODULE_PARM_DESC(tm_yuyv_chroma,
 	"YUYV host-tonemap chroma percent (0-300, default 300). 100=unity, >100 boosts.");
 
 int tm_yuyv_black = 0;
-module_param(tm_yuyv_black, int, 0644);
+module_param_cb(tm_yuyv_black, &sc0710_tm_yuyv_ops, &tm_yuyv_black, 0644);
 MODULE_PARM_DESC(tm_yuyv_black,
 	"YUYV output black lift above code 16 (0-40, default 0).");
 
 int tm_yuyv_white = 235;
-module_param(tm_yuyv_white, int, 0644);
+module_param_cb(tm_yuyv_white, &sc0710_tm_yuyv_ops, &tm_yuyv_white, 0644);
 MODULE_PARM_DESC(tm_yuyv_white,
 	"YUYV output white clip (180-235, default 235).");
 
 int tm_yuyv_u = 100;
-module_param(tm_yuyv_u, int, 0644);
+module_param_cb(tm_yuyv_u, &sc0710_tm_yuyv_ops, &tm_yuyv_u, 0644);
 MODULE_PARM_DESC(tm_yuyv_u,
 	"YUYV Cb/U scale percent after chroma retain (50-150, default 100).");
 
 int tm_yuyv_v = 100;
-module_param(tm_yuyv_v, int, 0644);
+module_param_cb(tm_yuyv_v, &sc0710_tm_yuyv_ops, &tm_yuyv_v, 0644);
 MODULE_PARM_DESC(tm_yuyv_v,
 	"YUYV Cr/V scale percent after chroma retain (50-150, default 100).");
 
 int tm_yuyv_pq_bias = 0;
-module_param(tm_yuyv_pq_bias, int, 0644);
+module_param_cb(tm_yuyv_pq_bias, &sc0710_tm_yuyv_ops, &tm_yuyv_pq_bias, 0644);
 MODULE_PARM_DESC(tm_yuyv_pq_bias,
 	"YUYV PQ index bias before nits lookup (-40..40, default 0).");
 
 int tm_yuyv_oetf = 0;
-module_param(tm_yuyv_oetf, int, 0644);
+module_param_cb(tm_yuyv_oetf, &sc0710_tm_yuyv_ops, &tm_yuyv_oetf, 0644);
 MODULE_PARM_DESC(tm_yuyv_oetf,
 	"YUYV output OETF: 0=Rec.709 limited, 1=sRGB→limited, 2=linear→limited.");
 
@@ -187,27 +202,47 @@ MODULE_PARM_DESC(tm_yuyv_oetf,
  * BGR24 host-tonemap fine-tune (sc0710-hdr-config 4:4:4 section).
  * Defaults: T=0.50, paper 400 nits, gain 150%, sat 150% (user-tuned look).
  * Baked gold path (T=0.58 / paper 203) still used when knobs match those.
+ * Writes rebuild the tonemap's cached tables on the next frame.
  */
+static int sc0710_param_set_tm_bgr(const char *val,
+				   const struct kernel_param *kp)
+{
+	int ret = param_set_int(val, kp);
+
+	if (!ret)
+		sc0710_tm_bgr_knobs_changed();
+	return ret;
+}
+static const struct kernel_param_ops sc0710_tm_bgr_ops = {
+	.set = sc0710_param_set_tm_bgr,
+	.get = param_get_int,
+};
+
 int tm_bgr_target = 50;
-module_param(tm_bgr_target, int, 0644);
+module_param_cb(tm_bgr_target, &sc0710_tm_bgr_ops, &tm_bgr_target, 0644);
 MODULE_PARM_DESC(tm_bgr_target,
 	"BGR24 Reinhard target T×100 (10-80, default 50). Higher = brighter midtones.");
 
 int tm_bgr_paper = 400;
-module_param(tm_bgr_paper, int, 0644);
+module_param_cb(tm_bgr_paper, &sc0710_tm_bgr_ops, &tm_bgr_paper, 0644);
 MODULE_PARM_DESC(tm_bgr_paper,
 	"BGR24 tonemap paper-white nits (50-400, default 400). Higher = dimmer highlights.");
 
 int tm_bgr_gain = 150;
-module_param(tm_bgr_gain, int, 0644);
+module_param_cb(tm_bgr_gain, &sc0710_tm_bgr_ops, &tm_bgr_gain, 0644);
 MODULE_PARM_DESC(tm_bgr_gain,
 	"BGR24 post-tonemap RGB gain percent (50-150, default 150).");
 
 int tm_bgr_chroma = 150;
-module_param(tm_bgr_chroma, int, 0644);
+module_param_cb(tm_bgr_chroma, &sc0710_tm_bgr_ops, &tm_bgr_chroma, 0644);
 MODULE_PARM_DESC(tm_bgr_chroma,
 	"BGR24 post-tonemap saturation percent (0-300, default 150). 100=unity, >100 boosts.");
 
+int tm_bgr_lut = 1;
+module_param(tm_bgr_lut, int, 0644);
+MODULE_PARM_DESC(tm_bgr_lut,
+	"BGR24 tonemap via bit-exact cached tables (1, default) or the per-pixel curve (0).");
+
 /* Module parameter to enable status images (No Signal/No Device BMP)
  * 1 = show BMP images (default), 0 = show colorbars
  */
@@ -1319,18 +1354,25 @@ static int sc0710_buf_prepare(struct vb2_buffer *vb)
 
 	if (zero_copy) {
 		struct sg_table *sgt = vb2_dma_sg_plane_desc(vb, 0);
+		bool imported = vb->memory == VB2_MEMORY_DMABUF;
 		struct scatterlist *sg;
 		unsigned int i;
+		int ret;
 
 		/* Snapshot the plane's DMA segments for descriptor targeting.
 		 * A plane scattered across more segments than the frame chain
 		 * has descriptors can't be DMA'd into; refuse it rather than
 		 * silently degrade (strict mode). With an IOMMU the whole
-		 * plane typically maps as one segment. */
+		 * plane typically maps as one segment. An imported dma-buf
+		 * comes from someone else's allocator, so it is served
+		 * through the copy path instead, if it can be. */
 		buf->zc_nsegs = 0;
+		buf->zc_need_sync = false;
 		for_each_sgtable_dma_sg(sgt, sg, i) {
 			if (i >= SC0710_MAX_CHAIN_DESCRIPTORS) {
 				buf->zc_nsegs = 0;
+				if (imported)
+					break;
 				printk_ratelimited(KERN_WARNING
 					"%s: zero-copy: buffer memory too fragmented for direct DMA (more than %u segments), refusing buffer\n",
 					dev->name, SC0710_MAX_CHAIN_DESCRIPTORS);
@@ -1339,17 +1381,44 @@ static int sc0710_buf_prepare(struct vb2_buffer *vb)
 			buf->zc_seg[i].addr = sg_dma_address(sg);
 			buf->zc_seg[i].len  = sg_dma_len(sg);
 			buf->zc_nsegs = i + 1;
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(5, 9, 0)
+			if (dma_need_sync(&dev->pci->dev, sg_dma_address(sg)))
+				buf->zc_need_sync = true;
+#else
+			buf->zc_need_sync = true;
+#endif
+		}
+
+		/* Imported segments get the same checks the carve applies
+		 * per frame (sc0710_dma_chain_carve()); failing them here
+		 * routes the buffer to the copy path up front. */
+		ret = imported && buf->zc_nsegs ?
+			sc0710_dma_zc_validate(ch, buf, eff_fs) : 0;
+		if (ret < 0) {
+			printk_ratelimited(KERN_WARNING
+				"%s: zero-copy: imported buffer not DMA-targetable (%d), using the copy path\n",
+				dev->name, ret);
+			buf->zc_nsegs = 0;
 		}
 
-		dprintk(2, "%s() zero-copy buffer: %u DMA segment(s)\n",
-			__func__, buf->zc_nsegs);
+		dprintk(2, "%s() zero-copy %s buffer: %u DMA segment(s)\n",
+			__func__, imported ? "imported" : "driver", buf->zc_nsegs);
 
 		/* Map the kernel view now, in process context: the copy
 		 * fallback and placeholder paths read the vaddr under
 		 * spinlocks/timer context, where dma-sg's lazy first
-		 * mapping must not happen. */
-		if (!vb2_plane_vaddr(vb, 0))
-			return -ENOMEM;
+		 * mapping must not happen. An imported buffer whose exporter
+		 * can't vmap (GPU memory, often) is fine while the DMA can
+		 * target it; a copy delivery returns it as an error
+		 * (sc0710_dma_zc_unmapped_done()). */
+		buf->zc_unmapped = false;
+		if (!vb2_plane_vaddr(vb, 0)) {
+			if (!imported || !buf->zc_nsegs)
+				return -ENOMEM;
+			buf->zc_unmapped = true;
+			dprintk(1, "%s() imported buffer %u has no kernel mapping, direct DMA only\n",
+				__func__, vb->index);
+		}
 	}
 
 	vb2_set_plane_payload(vb, 0, eff_fs);
@@ -1366,12 +1435,57 @@ static void sc0710_buf_queue(struct vb2_buffer *vb)
 	struct sc0710_buffer *buf = container_of(vbuf, struct sc0710_buffer, vb);
 	unsigned long flags;
 
+	buf->done_ns = 0;
+
 	/* Add buffer to this client's buffer list */
 	spin_lock_irqsave(&client->buffer_lock, flags);
 	list_add_tail(&buf->list, &client->buffer_list);
 	spin_unlock_irqrestore(&client->buffer_lock, flags);
 }
 
+/* New memory behind the buffer (allocation, USERPTR pin or dma-buf
+ * attach): its zero-copy counters start over. */
+static int sc0710_buf_init(struct vb2_buffer *vb)
+{
+	struct vb2_v4l2_buffer *vbuf = to_vb2_v4l2_buffer(vb);
+	struct sc0710_buffer *buf = container_of(vbuf, struct sc0710_buffer, vb);
+
+	buf->zc_unmapped = false;
+	buf->zc_direct = 0;
+	buf->zc_copied = 0;
+	buf->zc_rejected = 0;
+	return 0;
+}
+
+/* The memory is going away: report how zero-copy served it. */
+static void sc0710_buf_cleanup(struct vb2_buffer *vb)
+{
+	struct vb2_v4l2_buffer *vbuf = to_vb2_v4l2_buffer(vb);
+	struct sc0710_client *client = vb2_get_drv_priv(vb->vb2_queue);
+	struct sc0710_buffer *buf = container_of(vbuf, struct sc0710_buffer, vb);
+	struct sc0710_dev *dev = client->fh->ch->dev;
+
+	if (zero_copy && (buf->zc_direct || buf->zc_copied || buf->zc_rejected))
+		dprintk(1, "%s() %s buffer %u: %u direct, %u copied, %u carves refused\n",
+			__func__, vb->memory == VB2_MEMORY_DMABUF ? "imported" : "driver",
+			vb->index, buf->zc_direct, buf->zc_copied, buf->zc_rejected);
+}
+
+/* vb2 calls this from DQBUF for the buffer being dequeued, and from the
+ * streamoff cancel (streaming already cleared, not a DQBUF). DQBUF is
+ * serialized per channel by the shared queue lock (ch->v4l2_lock). */
+static void sc0710_buf_finish(struct vb2_buffer *vb)
+{
+	struct vb2_v4l2_buffer *vbuf = to_vb2_v4l2_buffer(vb);
+	struct sc0710_client *client = vb2_get_drv_priv(vb->vb2_queue);
+	struct sc0710_buffer *buf = container_of(vbuf, struct sc0710_buffer, vb);
+	u64 now = ktime_get_ns();
+
+	if (buf->done_ns && vb2_is_streaming(vb->vb2_queue) && now > buf->done_ns)
+		sc0710_lat_record(&client->fh->ch->lat_dqbuf, now - buf->done_ns);
+	buf->done_ns = 0;
+}
+
 /* Unwind a failed STREAMON: undo the streaming markers and hand every
  * queued buffer back to vb2 (the start_streaming failure contract). */
 static void sc0710_start_streaming_unwind(struct sc0710_dma_channel *ch,
@@ -1431,17 +1545,6 @@ static int sc0710_start_streaming(struct vb2_queue *q, unsigned int count)
 	refcount = atomic_inc_return(&ch->streaming_refcount);
 	dprintk(1, "%s() streaming refcount now %d\n", __func__, refcount);
 
-	/* Zero-copy is strict single-client: frames DMA into one client's
-	 * buffers, and there is no copy pass to fan out to a second. The
-	 * refcount doubles as the race-free exclusivity check. */
-	if (zero_copy && refcount > 1) {
-		printk_ratelimited(KERN_WARNING
-			"%s: zero-copy: a client is already streaming, refusing a second\n",
-			dev->name);
-		sc0710_start_streaming_unwind(ch, client);
-		return -EBUSY;
-	}
-
 	/* Only start DMA if we're the first streaming client AND have signal.
 	 * kthread_dma_lock serializes this against the HDMI thread's resync:
 	 * without it a resync between the refcount increment and the resize
@@ -1512,8 +1615,48 @@ static void sc0710_stop_streaming(struct vb2_queue *q)
 		}
 		timer_delete_sync(&ch->timeout);
 		mutex_unlock(&dev->kthread_dma_lock);
+	} else if (zero_copy) {
+		/* Others keep streaming, but chains may still DMA into this
+		 * client's buffers, which vb2 unmaps once we return. No
+		 * service pass can target it again (streaming is clear, and
+		 * the check below waits out a pass already in flight); the
+		 * chains it holds are only safe to take back with the engine
+		 * quiesced. Bounce just this video engine around the untarget,
+		 * as the resync's first phase does: audio and the pipeline GO
+		 * bit are left alone. The restart may begin mid-frame: drop
+		 * the first frames, as the resync does. */
+		mutex_lock(&dev->kthread_dma_lock);
+		if (!READ_ONCE(dev->disconnected) &&
+		    sc0710_dma_channel_targets(ch, client)) {
+			bool running = ch->state == STATE_RUNNING;
+
+			if (running)
+				sc0710_dma_channel_stop(ch);
+			sc0710_dma_channel_untarget_all(ch);
+			if (running) {
+				int ret;
+
+				mutex_lock(&ch->lock);
+				ch->skip_next_frames = 3;
+				mutex_unlock(&ch->lock);
+
+				ret = sc0710_dma_channel_start_prep(ch);
+				if (ret == 0)
+					ret = sc0710_dma_channel_start(ch);
+				if (ret < 0)
+					printk(KERN_ERR "%s: zero-copy: video DMA restart after STREAMOFF failed (%d)\n",
+					       dev->name, ret);
+			}
+		}
+		mutex_unlock(&dev->kthread_dma_lock);
 	}
 
+	/* A service pass may hold one of this client's buffers off its
+	 * queue (the in-place interlaced weave); with streaming cleared it
+	 * puts it back before dropping ch->lock, so wait that pass out. */
+	mutex_lock(&ch->lock);
+	mutex_unlock(&ch->lock);
+
 	/* Release all active buffers for this client */
 	spin_lock_irqsave(&client->buffer_lock, flags);
 	list_for_each_entry_safe(buf, tmp, &client->buffer_list, list) {
@@ -1525,8 +1668,11 @@ static void sc0710_stop_streaming(struct vb2_queue *q)
 
 static const struct vb2_ops sc0710_video_qops = {
 	.queue_setup     = sc0710_queue_setup,
+	.buf_init        = sc0710_buf_init,
 	.buf_prepare     = sc0710_buf_prepare,
 	.buf_queue       = sc0710_buf_queue,
+	.buf_finish      = sc0710_buf_finish,
+	.buf_cleanup     = sc0710_buf_cleanup,
 	.start_streaming = sc0710_start_streaming,
 	.stop_streaming  = sc0710_stop_streaming,
 #if LINUX_VERSION_CODE < KERNEL_VERSION(7, 0, 0)
@@ -2039,7 +2185,14 @@ static void sc0710_vid_timeout(struct timer_list *t)
 		if (!list_empty(&client->buffer_list)) {
 			buf = list_first_entry(&client->buffer_list, struct sc0710_buffer, list);
 
-			dst = vb2_plane_vaddr(&buf->vb.vb2_buf, 0);
+			dst = sc0710_buf_vaddr(buf);
+			if (!dst && buf->zc_unmapped) {
+				/* Only the DMA can fill it; don't let it hold
+				 * up the placeholders queued behind it. */
+				sc0710_dma_zc_unmapped_done(ch, buf);
+				spin_unlock_irqrestore(&client->buffer_lock, buf_flags);
+				continue;
+			}
 			if (!dst) {
 				if (sc0710_debug_mode)
 					printk_ratelimited(KERN_ERR "%s: vb2_plane_vaddr returned NULL\n", dev->name);
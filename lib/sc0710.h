@@ -36,6 +36,10 @@
 #include <linux/mutex.h>
 #include <linux/kthread.h>
 #include <linux/workqueue.h>
+#include <linux/completion.h>
+#include <linux/log2.h>
+#include <linux/percpu.h>
+#include <linux/u64_stats_sync.h>
 #include <linux/freezer.h>
 #include <linux/v4l2-dv-timings.h>
 #include <media/v4l2-device.h>
@@ -94,13 +98,47 @@ extern unsigned int zero_copy;
  * descriptors per video chain; 0 = keep the default 4 MiB segmenting. */
 extern unsigned int zc_split;
 
+/* Streaming scratch ring (stream_scratch= module param, load-time only):
+ * back video chains with streaming mappings of cacheable pages instead of
+ * coherent allocations. */
+extern unsigned int stream_scratch;
+
+/* Video descriptor ring depth in chains (ring_depth= module param,
+ * load-time only); 0 = per mode, from frame rate and frame size. */
+extern unsigned int ring_depth;
+
+/* Probe-time scratch pool (scratch_pool= module param, load-time only):
+ * reserve the video ring's coherent scratch once, for the largest mode. */
+extern unsigned int scratch_pool;
+
+/* Multi-client fan-out (fanout_gather= module param): gather each frame out
+ * of the scratch ring once and copy every client from cached memory. */
+extern unsigned int fanout_gather;
+
+/* Pixel worker pool (px_workers= module param, load-time only): stripes a
+ * frame's tonemap, weave and tear-scan run in; 0 = auto, 1 = inline on the
+ * DMA thread. */
+extern unsigned int px_workers;
+
+/* Completed-frame handoff (frame_handoff= module param): the DMA thread
+ * only snapshots a completed video chain under ch->lock; conversion and
+ * client delivery run on the device's delivery worker. */
+extern unsigned int frame_handoff;
+
+/* Statistics rate windows in seconds (stats_windows= module param), as
+ * shown in /proc/sc0710-state. */
+extern unsigned int stats_windows[];
+extern unsigned int stats_windows_count;
+
 #define SC0710_MAX_CHANNELS 2
 
 /* A chain contains 1..SC0710_MAX_CHAIN_DESCRIPTORS descriptors,
  * multiple DMA allocations and multiple descriptors to
- * target the buffer pieces.
+ * target the buffer pieces. A ring holds MIN..MAX chains, and every
+ * descriptor of it must fit the channel's one descriptor page.
  */
-#define SC0710_MAX_CHANNEL_DESCRIPTOR_CHAINS 4
+#define SC0710_MIN_CHANNEL_DESCRIPTOR_CHAINS 4
+#define SC0710_MAX_CHANNEL_DESCRIPTOR_CHAINS 16
 #define SC0710_MAX_CHAIN_DESCRIPTORS 32
 
 #define UNSET (-1U)
@@ -150,15 +188,44 @@ struct sc0710_subid {
 
 struct sc0710_dev;
 
-struct sc0710_things_per_second
-{
-#if LINUX_VERSION_CODE <= KERNEL_VERSION(4,0,0)
-	struct old_timespec32 lastTime;
-#else
-	u64 lastTime;
-#endif
-	u64 persecond;
-	u64 accumulator;
+/* Pixel worker pool (sc0710-stripes.c): a frame's pixel passes are split
+ * into horizontal stripes, one per worker, dispatched by the DMA thread. */
+#define SC0710_PX_MAX_STRIPES 16
+
+typedef void (*sc0710_px_fn)(void *arg, u32 y0, u32 y1, int stripe);
+
+struct sc0710_px_pool;
+
+struct sc0710_px_stripe {
+	struct work_struct         work;
+	struct sc0710_px_pool     *pool;
+	int                        idx;
+	u32                        y0, y1;
+
+	/* Under the pool's stats_lock: stripe 0 is also written by inline
+	 * runs, which hold no dispatch lock and can overlap a dispatch. */
+	u64                        runs;
+	u64                        last_ns;
+	u64                        max_ns;
+	u64                        total_ns;
+};
+
+struct sc0710_px_pool {
+	struct workqueue_struct   *wq;        /* NULL: stripes run inline */
+	u32                        workers;
+	struct mutex               lock;      /* One dispatch at a time */
+	spinlock_t                 stats_lock; /* Stripe run stats */
+	atomic_t                   pending;
+	struct completion          done;
+	sc0710_px_fn               fn;
+	void                      *arg;
+	struct sc0710_px_stripe    stripe[SC0710_PX_MAX_STRIPES];
+
+	/* Dispatch to last stripe done, as seen by the DMA thread. */
+	u64                        dispatches;
+	u64                        wall_last_ns;
+	u64                        wall_max_ns;
+	u64                        wall_total_ns;
 };
 
 /* buffer for one video frame */
@@ -171,6 +238,7 @@ struct sc0710_buffer
 	/* sc0710 specific */
 	const struct sc0710_format *fmt;
 	u32 expected_framesize;
+	u64 done_ns;	/* vb2_buffer_done time of a captured frame, else 0 */
 
 	/* Zero-copy: DMA-segment snapshot of the mapped plane, taken at
 	 * buf_prepare. zc_nsegs == 0 means the plane is not directly
@@ -180,8 +248,31 @@ struct sc0710_buffer
 		dma_addr_t addr;
 		u32        len;
 	} zc_seg[SC0710_MAX_CHAIN_DESCRIPTORS];
+
+	/* Imported (DMABUF) plane its exporter would not map into the
+	 * kernel: only the DMA can fill it. CPU paths must go through
+	 * sc0710_buf_vaddr() - a retried vmap would sleep under their
+	 * spinlocks. */
+	bool zc_unmapped;
+
+	/* Some segment needs explicit CPU/device syncs (swiotlb bounce,
+	 * non-coherent DMA): CPU writes to the plane never reach a
+	 * DMA_FROM_DEVICE mapping, so the host tonemap can't run on it
+	 * in place. */
+	bool zc_need_sync;
+
+	/* Frames delivered into this buffer directly and through a copy,
+	 * and failed carves, since its memory was attached (buf_init). */
+	u32 zc_direct;
+	u32 zc_copied;
+	u32 zc_rejected;
 };
 
+static inline void *sc0710_buf_vaddr(struct sc0710_buffer *buf)
+{
+	return buf->zc_unmapped ? NULL : vb2_plane_vaddr(&buf->vb.vb2_buf, 0);
+}
+
 struct sc0710_dmaqueue {
 	struct list_head   active;
 	struct list_head   queued;
@@ -220,6 +311,18 @@ enum sc0710_channel_state_e
 	STATE_RUNNING
 };
 
+/* Zero-copy targeting after staleness-sentinel trips: a trip holds the
+ * copy path until the resync rebuilds the ring, then targeting resumes on
+ * probation; a trip on probation, or too many in a row, ends it for the
+ * session. */
+enum sc0710_zc_state_e
+{
+	ZC_STATE_ACTIVE = 0,
+	ZC_STATE_TRIPPED,
+	ZC_STATE_PROBATION,
+	ZC_STATE_DISABLED
+};
+
 /* Take the size of an ideal DMA transfer (say, the size of a 4K image 3840 * 2 * 2160 bytes).
  * Fragment this into 4MB PCI allocations, so for 4K we have:
  * allocsegment = 4 * 1048576 = 4194304
@@ -234,19 +337,30 @@ struct sc0710_dma_descriptor_chain
 	int enabled;
 	int total_transfer_size;
 
-	/* Multiple DMA allocations holding an entire video frame, or audio buffer. */
+	/* Multiple DMA allocations holding an entire video frame, or audio buffer.
+	 * A resize to a smaller frame re-describes the ring over the allocations
+	 * it already holds: numBacked of them are allocated, the first
+	 * numAllocations are described to the engine. */
 	u32 numAllocations;
+	u32 numBacked;
 	struct sc0710_dma_descriptor_chain_allocation {
         int                           enabled;
 		struct sc0710_dma_descriptor *desc;
-		u32                           buf_size; /* PCI allocation size in bytes, of each allocation */
+		u32                           buf_size; /* Bytes described to the engine */
+		u32                           alloc_size; /* PCI allocation size in bytes, of each allocation */
 		u64                          *buf_cpu;  /* Virtual address */
 		dma_addr_t                    buf_dma;  /* Physical address - accessible to the PCIe endpoint */
 		u32                          *wbm[2];   /* Write back metadata where we can monitor descriptor completion */
 		u32                          *wbm_cpu;  /* Writeback base; wbm[] picks the active half */
 		dma_addr_t                    wbm_dma;  /* Writeback slot base (device) */
+		bool                          pooled;   /* Carved from ch->pool, never freed */
 	} allocations[SC0710_MAX_CHAIN_DESCRIPTORS];
 
+	/* Allocations are streaming mappings (stream_scratch=1) of cacheable
+	 * pages rather than coherent memory: the CPU must sync each completed
+	 * lap before reading it and hand it back to the device afterwards. */
+	bool streaming;
+
 	/* Zero-copy: non-NULL while the chain's descriptors point at a client's
 	 * buffer instead of the coherent scratch allocations above. Written only
 	 * under ch->lock. */
@@ -257,6 +371,22 @@ struct sc0710_dma_descriptor_chain
 	u32 wbm_phase;
 };
 
+/* Coherent scratch reserved at probe (scratch_pool=1). A ring build
+ * carves its allocations out of the segments front to back, a free just
+ * rewinds the cursor: resizes never allocate, so a fragmented host can't
+ * fail one. Allocations the pool can't hold fall back to their own. */
+struct sc0710_dma_pool
+{
+	u32 nsegs;
+	u32 seg_size;
+	struct sc0710_dma_pool_seg {
+		void       *cpu;
+		dma_addr_t  dma;
+	} *seg;
+	u32 next_seg;   /* Carve cursor */
+	u32 next_off;
+};
+
 /* Forward declaration for multi-client support */
 struct sc0710_fh;
 
@@ -281,6 +411,121 @@ struct sc0710_client {
 	struct vb2_queue         vb2_queue;
 };
 
+/* Completed-frame handoff slot: a snapshot of one completed video chain,
+ * owned by the delivery worker from the moment it is queued until it has
+ * been delivered. The buffer is kept and reused across frames. */
+#define SC0710_HANDOFF_SLOTS 3
+
+struct sc0710_handoff_slot {
+	u8                          *buf;
+	u32                          size;       /* Allocation size */
+	u32                          framesize;
+	u32                          width;
+	u32                          height;
+	u32                          interlaced;
+	u64                          ts_ns;      /* Snapshot time */
+	u32                          sequence;   /* Reserved at admission */
+};
+
+/* Capture timestamp jitter histogram buckets, per channel. */
+#define SC0710_TS_JITTER_BUCKETS 8
+
+/* Completion interrupt stamps not yet paired with a chain, per channel.
+ * Each carries the completed-descriptor count read in the interrupt, so a
+ * service pass can tell which completion it belongs to. Power of two. */
+#define SC0710_IRQ_TS_RING 16
+
+struct sc0710_irq_stamp {
+	u32                          count;
+	u64                          ns;
+};
+
+/* Frame latency histogram, log2 microseconds: bucket n holds samples of
+ * [2^n, 2^(n+1)) us (bucket 0 everything under 2 us), the last bucket
+ * everything longer. One writer at a time; procfs reads tolerate a torn
+ * sample. A procfs reset only raises reset_pending: the writer zeroes the
+ * histogram before its next sample, so nothing clears the 64-bit sums
+ * under a concurrent update. */
+#define SC0710_LAT_BUCKETS 20
+
+struct sc0710_lat_hist {
+	u64 bucket[SC0710_LAT_BUCKETS];
+	u64 count;
+	u64 sum_ns;
+	u64 max_ns;
+	bool reset_pending;
+};
+
+static inline void sc0710_lat_record(struct sc0710_lat_hist *h, u64 ns)
+{
+	u64 us = div_u64(ns, 1000);
+	u32 b = us > 1 ? ilog2(us) : 0;
+
+	if (unlikely(READ_ONCE(h->reset_pending))) {
+		memset(h->bucket, 0, sizeof(h->bucket));
+		h->count = 0;
+		h->sum_ns = 0;
+		h->max_ns = 0;
+		WRITE_ONCE(h->reset_pending, false);
+	}
+
+	h->bucket[min_t(u32, b, SC0710_LAT_BUCKETS - 1)]++;
+	h->count++;
+	h->sum_ns += ns;
+	if (ns > h->max_ns)
+		h->max_ns = ns;
+}
+
+/* Per-channel counters (sc0710-stats.c). Writers bump their CPU's copy
+ * lock-free; readers sum every CPU's copy under its u64_stats_sync, so
+ * the totals are consistent 64-bit values on 32-bit hosts too. Nothing on
+ * the hot path reads the clock: rates come from a once-a-second sample
+ * history, computed when they are read. */
+enum sc0710_stat_e {
+	SC0710_STAT_BYTES = 0,
+	SC0710_STAT_FRAMES,	/* Chains serviced: video frames, audio periods */
+	SC0710_STAT_DESCS,
+	SC0710_STAT_DROPS,	/* Overwritten in the ring or dropped at handoff */
+	SC0710_STAT_COPIES,	/* Frames delivered through the copy path */
+	SC0710_STAT_ZC_HITS,	/* Frames DMA'd straight into a client buffer */
+	SC0710_STAT_SAMPLES,	/* Audio samples, all channels */
+	SC0710_STAT_COUNT
+};
+
+struct sc0710_stats_pcpu {
+	u64_stats_t             val[SC0710_STAT_COUNT];
+	struct u64_stats_sync   syncp;
+};
+
+/* One sample a second, enough history for the longest rate window. */
+#define SC0710_STATS_HISTORY 64
+#define SC0710_STATS_MAX_WINDOW 60
+#define SC0710_STATS_WINDOWS 3
+
+/* Layout version of the sysfs stats group (stats/version). */
+#define SC0710_STATS_ABI_VERSION 1
+
+struct sc0710_stats {
+	struct sc0710_stats_pcpu __percpu *pcpu;
+
+	/* Sample history, written by the per-device sampler only. */
+	spinlock_t              hist_lock;
+	u64                     hist[SC0710_STATS_HISTORY][SC0710_STAT_COUNT];
+	u64                     hist_ns[SC0710_STATS_HISTORY];
+	u32                     hist_head;  /* Next slot to write */
+	u32                     hist_count;
+};
+
+static inline void sc0710_stat_add(struct sc0710_stats *s, enum sc0710_stat_e i, u64 v)
+{
+	struct sc0710_stats_pcpu *p = get_cpu_ptr(s->pcpu);
+
+	u64_stats_update_begin(&p->syncp);
+	u64_stats_add(&p->val[i], v);
+	u64_stats_update_end(&p->syncp);
+	put_cpu_ptr(s->pcpu);
+}
+
 struct sc0710_dma_channel
 {
 	struct sc0710_dev           *dev;
@@ -304,7 +549,18 @@ struct sc0710_dma_channel
 	struct mutex                 v4l2_lock; /* Separate lock for V4L2/VB2 serialization */
 	u32                          numDescriptorChains;
 	u32                          buf_size;
-	struct sc0710_dma_descriptor_chain chains[SC0710_MAX_CHANNEL_DESCRIPTOR_CHAINS];
+	/* maxDescriptorChains entries, allocated with the channel; a resize
+	 * picks how many of them the ring uses. */
+	u32                          maxDescriptorChains;
+	struct sc0710_dma_descriptor_chain *chains;
+	struct sc0710_dma_pool       pool;
+
+	/* Ring resizes: re-cut over the existing allocations vs. rebuilt,
+	 * and how long the last and slowest one took. */
+	u64                          resize_recut;
+	u64                          resize_rebuilt;
+	u64                          resize_last_ns;
+	u64                          resize_max_ns;
 
 	/* DMA Controller PCI BAR offsets */
 	u32                          register_dma_base;
@@ -329,10 +585,84 @@ struct sc0710_dma_channel
 	u32                          dma_completed_descriptor_count_last;
 	unsigned long                dma_last_completion_jiffies;
 
+	/* Ring overrun accounting while the ring free-runs (no credit
+	 * gating): chains the completed-descriptor counter says finished vs
+	 * chains the service loop consumed. A lap overwritten before it was
+	 * serviced shows up as a shortfall. The session totals restart at
+	 * start_prep; ring_overruns is cumulative. */
+	u64                          ring_desc_session;
+	u64                          ring_laps_session;
+	u64                          ring_lost_session;
+	u64                          ring_overruns;
+
+	/* Frames dropped (ring overrun, handoff full) since the last frame
+	 * handed to delivery; that frame's sequence number skips them. */
+	u32                          seq_gap_pending;
+
+	/* Capture timestamps. The interrupt handler pushes one stamp per
+	 * completion interrupt (the hard IRQ is the only producer, the
+	 * service pass under ch->lock the only consumer); the pass pairs
+	 * each chain it consumes with the first stamp whose count covers the
+	 * chain's end, ts_desc_done being the count at the end of the last
+	 * chain consumed. A frame without one takes the time of the pass
+	 * that found it. The intervals feed a jitter histogram. Buckets:
+	 * <50us, <100us, <250us, <500us, <1ms, <2ms, <5ms, more. */
+	struct sc0710_irq_stamp      irq_ts_ring[SC0710_IRQ_TS_RING];
+	atomic_t                     irq_ts_head;
+	u32                          irq_ts_tail;
+	u32                          ts_desc_done;
+	u64                          ts_session_ns;
+	u64                          ts_last_ns;
+	u64                          ts_period_ns;   /* Smoothed frame interval */
+	u32                          ts_reject_streak;
+	u64                          ts_from_irq;
+	u64                          ts_from_poll;
+	u64                          ts_gaps;
+	u64                          ts_jitter_hist[SC0710_TS_JITTER_BUCKETS];
+	u64                          ts_jitter_sum_ns;
+	u64                          ts_jitter_max_ns;
+	u64                          ts_jitter_samples;
+
+	/* Adaptive completion polling, owned by the thread that services
+	 * this channel: the estimated time of the last chain completion and
+	 * the chain period that predicts the next one; early wakes since
+	 * then. Totals: that thread's timed wakes, and those that found the
+	 * predicted chain vs. woke before it landed. */
+	u32                          poll_count;     /* Completed count last seen */
+	u32                          poll_early;
+	u32                          poll_rejects;
+	u64                          poll_anchor_ns;
+	u64                          poll_period_ns; /* Measured; video prefers ts_period_ns */
+	u64                          poll_wakes;
+	u64                          poll_on_time;
+	u64                          poll_early_total;
+
+	/* Frame latency: capture timestamp to dequeue start, dequeue start
+	 * to vb2_buffer_done (per buffer), buffer done to the client's
+	 * DQBUF. Writing "reset" to /proc/sc0710-state clears them. */
+	struct sc0710_lat_hist       lat_detect;
+	struct sc0710_lat_hist       lat_deliver;
+	struct sc0710_lat_hist       lat_dqbuf;
+	/* Completion interrupt to the service pass that picked it up. */
+	struct sc0710_lat_hist       lat_service;
+
+	/* How long a service pass that consumed work held ch->lock. */
+	u64                          service_hold_last_ns;
+	u64                          service_hold_max_ns;
+
+	/* Completed-frame handoff queue: handoff_head is the oldest queued
+	 * slot, handoff_count includes the one being delivered. Only the
+	 * service loop adds and only the delivery worker removes. */
+	struct sc0710_handoff_slot   handoff[SC0710_HANDOFF_SLOTS];
+	spinlock_t                   handoff_lock;
+	u32                          handoff_head;
+	u32                          handoff_count;
+	struct work_struct           handoff_work;
+	u64                          handoff_frames;
+	u64                          handoff_drops;  /* Worker behind, all slots full */
+
 	/* Statistics */
-	struct sc0710_things_per_second bitsPerSecond;
-	struct sc0710_things_per_second descPerSecond;
-	struct sc0710_things_per_second audioSamplesPerSecond;
+	struct sc0710_stats          stats;
 
 	/* Channel 0 */
 	/* V4L2 */
@@ -352,16 +682,49 @@ struct sc0710_dma_channel
 	int                          tear_last_line;
 	u32                          tear_resync_retries_left;
 
-	/* Zero-copy delivery counters (frames DMA'd straight into a client
-	 * buffer vs. delivered through the copy path while zero_copy=1). */
+	/* Zero-copy delivery counters (frames DMA'd straight into the lead
+	 * client's buffer vs. delivered through the copy path while
+	 * zero_copy=1, and copies of direct frames fanned out to the other
+	 * clients). Tonemapped counts the direct frames the host tonemap
+	 * rewrote in place in the client buffer. */
 	u64                          zc_frames_direct;
 	u64                          zc_frames_copied;
+	u64                          zc_frames_shared;
+	u64                          zc_frames_tonemapped;
+
+	/* The same split for imported (DMABUF) buffers only, carves
+	 * refused by segment validation (any buffer), and unmapped imports
+	 * a copy delivery (or the in-place tonemap) returned as errors -
+	 * bumped from the placeholder timer too, hence atomic. */
+	u64                          zc_import_direct;
+	u64                          zc_import_copied;
+	u64                          zc_carve_rejects;
+	atomic64_t                   zc_import_errors;
+
+	/* Scratch-ring read accounting: bytes copied out of the DMA scratch
+	 * allocations, and frames handed to at least one client (copied or
+	 * direct). Their ratio is the scratch read cost per output frame.
+	 * The byte count is atomic: pixel-pool stripes read concurrently. */
+	atomic64_t                   scratch_bytes_read;
+	u64                          frames_out;
+
+	/* Interlaced frames woven straight from the scratch ring into a
+	 * client buffer (no staging copy for that client). */
+	u64                          weave_direct;
 
 	/* Staleness sentinel: every chain rewrite moves the descriptors'
 	 * writeback to the other half of their slots, so a write landing in
 	 * the retired half proves the device consumed a pre-rewrite (stale)
-	 * descriptor. A trip permanently forces the copy path. */
+	 * descriptor. A trip forces the copy path (zc_stale_trip) until the
+	 * resync re-arms targeting on probation: zc_probation_laps clean
+	 * sentinel laps to go. zc_trips_recent counts trips within the trip
+	 * window of each other. */
 	bool                         zc_stale_trip;
+	enum sc0710_zc_state_e       zc_state;
+	u32                          zc_probation_laps;
+	u32                          zc_trips;
+	u32                          zc_trips_recent;
+	u64                          zc_trip_last_ns;
 	u64                          zc_wbm_flips;
 	u64                          zc_stale_events;
 	u64                          zc_stale_descs;
@@ -483,6 +846,12 @@ struct sc0710_dev {
  	struct task_struct         *kthread_dma;
 	struct mutex               kthread_dma_lock;
 
+	/* Audio is serviced by its own thread under its channel lock alone,
+	 * so a long video pass (dequeue, tonemap) never delays a period. */
+	struct task_struct         *kthread_audio;
+	wait_queue_head_t          audio_wq;
+	atomic_t                   audio_irq_pending;
+
 	/* Misc structs */
 	struct sc0710_i2c          i2cbus[1];
 
@@ -531,6 +900,12 @@ struct sc0710_dev {
 	u8                        *weave_staging_buf;   /* Destination for interlaced field weaving */
 	u32                        weave_staging_size;
 
+	/* Stripe-parallel tonemap / weave / tear-scan workers */
+	struct sc0710_px_pool      px;
+	struct workqueue_struct   *dq_wq;  /* Completed-frame delivery worker */
+	struct delayed_work        stats_work;  /* Once-a-second stats sampler */
+	bool                       stats_sysfs; /* stats/ group registered */
+
 	/* Procamp */
 	s32                        brightness;
 	s32                        contrast;
@@ -548,15 +923,26 @@ struct sc0710_dev {
 	int reconfig_in_progress;
 	int tear_resync_pending;
 
+	/* Mode-switch latency: each DMA resync, from its call (waiting for
+	 * the DMA lock included) to the restarted engines or the failure
+	 * bail. */
+	u64 resync_count;
+	u64 resync_last_ns;
+	u64 resync_max_ns;
+	u64 resync_sum_ns;
+
 	/* Interrupt-driven DMA service (irq_service) */
 	bool irq_requested;
 	bool irq_service_active;   /* line requested via MSI and service enabled */
 	bool irq_dead;             /* tripwire: interrupts lost, polling again */
+	bool irq_threaded;         /* irq_service=2: the IRQ thread services */
 	wait_queue_head_t dma_wq;
 	atomic_t dma_irq_pending;
+	atomic_t irq_ch_pending;   /* Threaded: channels whose engines fired */
+	u64  irq_thread_runs;
 	u64  irq_count;
 	u64  irq_missed;
-	u64  dma_completions;
+	atomic64_t dma_completions; /* Audio and video threads both add */
 	u32  irq_status_seen;      /* OR of engine statuses sampled in the handler */
 
 	/* Debounce: require consecutive stable polls before triggering reconfig */
@@ -635,7 +1021,9 @@ void sc0710_sync_hdr_deliver(struct sc0710_dev *dev);
 void sc0710_sync_hdr_deliver_ex(struct sc0710_dev *dev, bool defer_dma_resync);
 void sc0710_sync_hdr_deliver_all(void);
 void sc0710_yuyv8_sw_tonemap(u8 *yuyv, u32 w, u32 h);
+void sc0710_tm_yuyv_knobs_changed(void);
 void sc0710_bgr24_sw_tonemap(u8 *bgr, u32 w, u32 h);
+void sc0710_tm_bgr_knobs_changed(void);
 extern int color_deep; /* module_param in sc0710-video.c */
 extern int hdr_bgr24;
 extern int hw_tonemap;
@@ -654,6 +1042,7 @@ extern int tm_bgr_target;
 extern int tm_bgr_paper;
 extern int tm_bgr_gain;
 extern int tm_bgr_chroma;
+extern int tm_bgr_lut;
 extern int force_eotf;
 bool sc0710_edid_header_valid(const u8 *p);
 int sc0710_i2c_read_hdmi_status(struct sc0710_dev *dev);
@@ -686,6 +1075,12 @@ int  sc0710_dma_channel_start_prep(struct sc0710_dma_channel *ch);
 int  sc0710_dma_channel_start(struct sc0710_dma_channel *ch);
 int  sc0710_dma_channel_stop(struct sc0710_dma_channel *ch);
 void sc0710_dma_channel_untarget_all(struct sc0710_dma_channel *ch);
+bool sc0710_dma_channel_targets(struct sc0710_dma_channel *ch, struct sc0710_client *client);
+void sc0710_dma_channel_zc_rearm(struct sc0710_dma_channel *ch);
+void sc0710_dma_zc_unmapped_done(struct sc0710_dma_channel *ch, struct sc0710_buffer *buf);
+int  sc0710_dma_zc_validate(struct sc0710_dma_channel *ch, const struct sc0710_buffer *buf, u32 framesize);
+const char *sc0710_zc_state_ascii(enum sc0710_zc_state_e state);
+void sc0710_dma_channel_handoff_flush(struct sc0710_dma_channel *ch);
 int  sc0710_dma_channel_resize(struct sc0710_dev *dev, u32 nr, enum sc0710_channel_dir_e direction, u32 baseaddr,
 	enum sc0710_channel_type_e mediatype);
 enum sc0710_channel_state_e sc0710_dma_channel_state(struct sc0710_dma_channel *ch);
@@ -694,15 +1089,25 @@ enum sc0710_channel_state_e sc0710_dma_channel_state(struct sc0710_dma_channel *
 int  sc0710_dma_channels_alloc(struct sc0710_dev *dev);
 void sc0710_dma_channels_free(struct sc0710_dev *dev);
 int  sc0710_dma_channels_start(struct sc0710_dev *dev);
-int  sc0710_dma_channels_service(struct sc0710_dev *dev);
+int  sc0710_dma_channels_service(struct sc0710_dev *dev, enum sc0710_channel_type_e type);
 void sc0710_dma_channels_stop(struct sc0710_dev *dev);
 int  sc0710_dma_channels_resize(struct sc0710_dev *dev);
 void sc0710_program_pipeline_regs(struct sc0710_dev *dev);
 
-/* things-per-second.c */
-void sc0710_things_per_second_reset(struct sc0710_things_per_second *tps);
-void sc0710_things_per_second_update(struct sc0710_things_per_second *tps, s64 value);
-s64  sc0710_things_per_second_query(struct sc0710_things_per_second *tps);
+/* stripes.c */
+void sc0710_px_pool_init(struct sc0710_dev *dev);
+void sc0710_px_pool_free(struct sc0710_dev *dev);
+void sc0710_px_run(struct sc0710_dev *dev, u32 rows, sc0710_px_fn fn, void *arg);
+
+/* stats.c */
+int  sc0710_stats_init(struct sc0710_stats *s);
+void sc0710_stats_free(struct sc0710_stats *s);
+void sc0710_stats_read(struct sc0710_stats *s, u64 *tot);
+void sc0710_stats_rates(struct sc0710_stats *s, u32 window_s, u64 *tot, u64 *rate_x100);
+void sc0710_stats_start(struct sc0710_dev *dev);
+void sc0710_stats_stop(struct sc0710_dev *dev);
+int  sc0710_stats_sysfs_add(struct sc0710_dev *dev);
+void sc0710_stats_sysfs_remove(struct sc0710_dev *dev);
 
 /* video.c */
 void sc0710_video_unregister(struct sc0710_dma_channel *ch);
@@ -717,12 +1122,24 @@ const char *sc0710_colorspace_ascii(enum sc0710_colorspace_e val);
 /* -dma-chain.c */
 void sc0710_dma_chain_free(struct sc0710_dma_channel *ch, int nr);
 int  sc0710_dma_chain_alloc(struct sc0710_dma_channel *ch, int nr, int transfer_size);
+int  sc0710_dma_chain_recut(struct sc0710_dma_channel *ch, int nr, int transfer_size);
+u32  sc0710_dma_chain_segsize(struct sc0710_dma_channel *ch, int total_transfer_size);
+u32  sc0710_dma_chain_segments(struct sc0710_dma_channel *ch, int total_transfer_size);
 void sc0710_dma_chain_dump(struct sc0710_dma_channel *ch, struct sc0710_dma_descriptor_chain *chain, int nr);
 int sc0710_dma_chain_dq_to_ptr(struct sc0710_dma_channel *ch, struct sc0710_dma_descriptor_chain *chain, u8 *dst, int dstlen);
+int sc0710_dma_chain_copy_range(struct sc0710_dma_channel *ch, struct sc0710_dma_descriptor_chain *chain,
+	u32 off, u8 *dst, u32 len);
+void sc0710_dma_chain_sync_for_cpu(struct sc0710_dma_channel *ch, struct sc0710_dma_descriptor_chain *chain);
+void sc0710_dma_chain_sync_for_device(struct sc0710_dma_channel *ch, struct sc0710_dma_descriptor_chain *chain);
 
 /* -dma-chains.c */
 void sc0710_dma_chains_free(struct sc0710_dma_channel *ch);
 int  sc0710_dma_chains_alloc(struct sc0710_dma_channel *ch, int total_transfer_size);
+int  sc0710_dma_chains_recut(struct sc0710_dma_channel *ch, u32 depth, int total_transfer_size);
+int  sc0710_dma_pool_alloc(struct sc0710_dma_channel *ch, u32 nsegs, u32 seg_size);
+void sc0710_dma_pool_free(struct sc0710_dma_channel *ch);
+int  sc0710_dma_pool_carve(struct sc0710_dma_channel *ch,
+	struct sc0710_dma_descriptor_chain_allocation *dca);
 void sc0710_dma_chains_dump(struct sc0710_dma_channel *ch);
 
 /* -audio.c */
@@ -0,0 +1,295 @@
+/*
+ * sc0710-dmabuf-test — stream into imported dma-bufs (zero_copy=1).
+ *
+ * Allocates capture buffers with udmabuf (memfd pages exported as
+ * dma-bufs), streams with V4L2_MEMORY_DMABUF, and checks the "zc import:"
+ * counters in /proc/sc0710-state moved by the frames it got back:
+ *
+ *   - every good frame is counted as direct or copied,
+ *   - no buffer came back flagged as an error,
+ *   - no unmapped import was returned as an error.
+ *
+ * udmabuf pages are scattered 4 KiB pages, so without an IOMMU they exceed
+ * the descriptor budget and take the copy path; with one they are usually
+ * DMA'd into directly. Either passes; the split is printed.
+ *
+ * Needs a locked signal (placeholder frames are not counted as imports),
+ * sc0710 loaded with zero_copy=1 and the udmabuf module.
+ *
+ * build: cc -O2 -o scripts/sc0710-dmabuf-test scripts/sc0710-dmabuf-test.c
+ * run:   sudo scripts/sc0710-dmabuf-test /dev/video0 [frames] [buffers]
+ */
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <linux/udmabuf.h>
+#include <linux/videodev2.h>
+
+#define MAX_BUFS 16
+
+struct zc_import {
+	unsigned long long direct;
+	unsigned long long copied;
+	unsigned long long errors;
+	unsigned long long refused;
+};
+
+/* Sum the "zc import:" lines of every device and channel. */
+static int read_zc_import(struct zc_import *z)
+{
+	char line[512];
+	FILE *f = fopen("/proc/sc0710-state", "r");
+	int found = 0;
+
+	memset(z, 0, sizeof(*z));
+	if (!f) {
+		perror("/proc/sc0710-state");
+		return -1;
+	}
+	while (fgets(line, sizeof(line), f)) {
+		struct zc_import c;
+		char *p = strstr(line, "zc import:");
+
+		if (!p)
+			continue;
+		if (sscanf(p, "zc import: %llu direct, %llu copied, %llu unmapped errors; carves refused %llu",
+			   &c.direct, &c.copied, &c.errors, &c.refused) != 4) {
+			fprintf(stderr, "unexpected zc import line: %s", p);
+			fclose(f);
+			return -1;
+		}
+		z->direct += c.direct;
+		z->copied += c.copied;
+		z->errors += c.errors;
+		z->refused += c.refused;
+		found = 1;
+	}
+	fclose(f);
+	if (!found) {
+		fprintf(stderr, "no \"zc import:\" line in /proc/sc0710-state (is sc0710 loaded with zero_copy=1?)\n");
+		return -1;
+	}
+	return 0;
+}
+
+/* One udmabuf-backed dma-buf of @size bytes; the memfd is kept mapped
+ * for the content check. */
+static int alloc_dmabuf(int udmabuf, size_t size, uint8_t **map)
+{
+	struct udmabuf_create create;
+	int memfd, dmabuf;
+
+	memfd = memfd_create("sc0710-dmabuf-test", MFD_ALLOW_SEALING);
+	if (memfd < 0) {
+		perror("memfd_create");
+		return -1;
+	}
+	if (ftruncate(memfd, size) < 0 ||
+	    fcntl(memfd, F_ADD_SEALS, F_SEAL_SHRINK) < 0) {
+		perror("memfd size/seal");
+		close(memfd);
+		return -1;
+	}
+
+	memset(&create, 0, sizeof(create));
+	create.memfd = memfd;
+	create.flags = UDMABUF_FLAGS_CLOEXEC;
+	create.offset = 0;
+	create.size = size;
+	dmabuf = ioctl(udmabuf, UDMABUF_CREATE, &create);
+	if (dmabuf < 0) {
+		perror("UDMABUF_CREATE");
+		close(memfd);
+		return -1;
+	}
+
+	*map = mmap(NULL, size, PROT_READ, MAP_SHARED, memfd, 0);
+	close(memfd);
+	if (*map == MAP_FAILED) {
+		perror("mmap memfd");
+		close(dmabuf);
+		return -1;
+	}
+	return dmabuf;
+}
+
+static int any_nonzero(const uint8_t *p, size_t n)
+{
+	size_t i;
+
+	for (i = 0; i < n; i++)
+		if (p[i])
+			return 1;
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	struct v4l2_requestbuffers req;
+	struct v4l2_format fmt;
+	struct v4l2_buffer vb;
+	struct zc_import before, after;
+	enum v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+	int dmabuf[MAX_BUFS];
+	uint8_t *map[MAX_BUFS];
+	int frames, nbufs, fd, udmabuf, i;
+	int good = 0, flagged = 0, blank = 0;
+	unsigned long long counted;
+	size_t size, page = sysconf(_SC_PAGESIZE);
+	int fail = 0;
+
+	if (argc < 2) {
+		fprintf(stderr, "usage: %s /dev/videoN [frames] [buffers]\n", argv[0]);
+		return 2;
+	}
+	frames = argc > 2 ? atoi(argv[2]) : 120;
+	nbufs = argc > 3 ? atoi(argv[3]) : 4;
+	if (frames < 1 || nbufs < 2 || nbufs > MAX_BUFS) {
+		fprintf(stderr, "frames must be >= 1, buffers 2..%d\n", MAX_BUFS);
+		return 2;
+	}
+
+	fd = open(argv[1], O_RDWR);
+	if (fd < 0) {
+		perror("open video device");
+		return 1;
+	}
+	udmabuf = open("/dev/udmabuf", O_RDWR);
+	if (udmabuf < 0) {
+		perror("open /dev/udmabuf (modprobe udmabuf?)");
+		return 1;
+	}
+
+	memset(&fmt, 0, sizeof(fmt));
+	fmt.type = type;
+	if (ioctl(fd, VIDIOC_G_FMT, &fmt) < 0) {
+		perror("VIDIOC_G_FMT");
+		return 1;
+	}
+	size = (fmt.fmt.pix.sizeimage + page - 1) & ~(page - 1);
+	printf("%s: %ux%u, %u bytes/frame, %d udmabuf buffers of %zu bytes\n",
+	       argv[1], fmt.fmt.pix.width, fmt.fmt.pix.height,
+	       fmt.fmt.pix.sizeimage, nbufs, size);
+
+	if (read_zc_import(&before) < 0)
+		return 1;
+
+	memset(&req, 0, sizeof(req));
+	req.count = nbufs;
+	req.type = type;
+	req.memory = V4L2_MEMORY_DMABUF;
+	if (ioctl(fd, VIDIOC_REQBUFS, &req) < 0) {
+		perror("VIDIOC_REQBUFS");
+		return 1;
+	}
+	if ((int)req.count < nbufs)
+		nbufs = req.count;
+
+	for (i = 0; i < nbufs; i++) {
+		dmabuf[i] = alloc_dmabuf(udmabuf, size, &map[i]);
+		if (dmabuf[i] < 0)
+			return 1;
+
+		memset(&vb, 0, sizeof(vb));
+		vb.type = type;
+		vb.memory = V4L2_MEMORY_DMABUF;
+		vb.index = i;
+		vb.m.fd = dmabuf[i];
+		vb.length = size;
+		if (ioctl(fd, VIDIOC_QBUF, &vb) < 0) {
+			perror("VIDIOC_QBUF");
+			return 1;
+		}
+	}
+
+	if (ioctl(fd, VIDIOC_STREAMON, &type) < 0) {
+		perror("VIDIOC_STREAMON");
+		return 1;
+	}
+
+	for (i = 0; i < frames; i++) {
+		struct pollfd pfd = { .fd = fd, .events = POLLIN };
+		int ret = poll(&pfd, 1, 2000);
+
+		if (ret <= 0) {
+			fprintf(stderr, "frame %d: %s\n", i,
+				ret == 0 ? "timed out" : strerror(errno));
+			fail = 1;
+			break;
+		}
+
+		memset(&vb, 0, sizeof(vb));
+		vb.type = type;
+		vb.memory = V4L2_MEMORY_DMABUF;
+		if (ioctl(fd, VIDIOC_DQBUF, &vb) < 0) {
+			perror("VIDIOC_DQBUF");
+			fail = 1;
+			break;
+		}
+
+		if (vb.flags & V4L2_BUF_FLAG_ERROR) {
+			flagged++;
+		} else {
+			good++;
+			if (!any_nonzero(map[vb.index], vb.bytesused))
+				blank++;
+		}
+
+		vb.m.fd = dmabuf[vb.index];
+		vb.length = size;
+		if (ioctl(fd, VIDIOC_QBUF, &vb) < 0) {
+			perror("VIDIOC_QBUF (requeue)");
+			fail = 1;
+			break;
+		}
+	}
+
+	ioctl(fd, VIDIOC_STREAMOFF, &type);
+	memset(&req, 0, sizeof(req));
+	req.type = type;
+	req.memory = V4L2_MEMORY_DMABUF;
+	ioctl(fd, VIDIOC_REQBUFS, &req);
+
+	if (read_zc_import(&after) < 0)
+		return 1;
+
+	counted = (after.direct - before.direct) + (after.copied - before.copied);
+	printf("dequeued: %d good (%d all-zero), %d flagged as errors\n",
+	       good, blank, flagged);
+	printf("zc import: +%llu direct, +%llu copied, +%llu unmapped errors, +%llu carves refused\n",
+	       after.direct - before.direct, after.copied - before.copied,
+	       after.errors - before.errors, after.refused - before.refused);
+
+	if (flagged || after.errors != before.errors) {
+		fprintf(stderr, "FAIL: imported buffers came back as errors\n");
+		fail = 1;
+	}
+	if (good && counted == 0) {
+		fprintf(stderr, "FAIL: no frame was counted as an import (no signal? placeholders only)\n");
+		fail = 1;
+	} else if (counted < (unsigned long long)good) {
+		/* Another importer streaming at the same time only adds. */
+		printf("note: %llu of %d good frames counted as imports (the rest were placeholders)\n",
+		       counted, good);
+	}
+	if (blank)
+		printf("note: %d frame(s) were all zero\n", blank);
+
+	for (i = 0; i < nbufs; i++) {
+		munmap(map[i], size);
+		close(dmabuf[i]);
+	}
+	close(udmabuf);
+	close(fd);
+
+	printf("%s\n", fail ? "FAIL" : "PASS");
+	return fail;
+}
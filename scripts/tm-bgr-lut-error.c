@@ -0,0 +1,108 @@
+/*
+ * tm-bgr-lut-error — the BGR24 cached tables against the per-pixel curve.
+ *
+ * Feeds every one of the 2^24 BGR inputs through sc0710_bgr24_sw_tonemap()
+ * with tm_bgr_lut=1 and compares each output sample with the per-pixel
+ * curve (tm_bgr_lut=0) for the live defaults, the baked gold knobs, unity
+ * gain/saturation, full desaturation and an extreme knob set. Prints max /
+ * mean absolute error, the share of samples off by more than 4 codes and
+ * the worst input; the tables are meant to be bit-exact.
+ *
+ * run: bash scripts/tm-check.sh bgr-lut-error [max-allowed, default 0]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "sc0710-tonemap.c"
+
+int tm_yuyv_target = 80;
+int tm_paper_nits = 225;
+int tm_yuyv_gain = 100;
+int tm_yuyv_chroma = 300;
+int tm_yuyv_black;
+int tm_yuyv_white = 235;
+int tm_yuyv_u = 100;
+int tm_yuyv_v = 100;
+int tm_yuyv_pq_bias;
+int tm_yuyv_oetf;
+int tm_bgr_target = 50;
+int tm_bgr_paper = 400;
+int tm_bgr_gain = 150;
+int tm_bgr_chroma = 150;
+int tm_bgr_lut = 1;
+
+#define NPIX	(1u << 24)
+
+static const struct {
+	const char *name;
+	int target, paper, gain, chroma;
+} sets[] = {
+	{ "default", 50, 400, 150, 150 },
+	{ "gold",    58, SC0710_TM_PAPER_NITS, 100, 100 },
+	{ "unity",   80, 203, 100, 100 },
+	{ "gray",    50, 1, 60, 0 },
+	{ "extreme", 100, 40, 200, 300 },
+};
+
+static void fill(u8 *bgr)
+{
+	u32 p;
+
+	for (p = 0; p < NPIX; p++) {
+		bgr[p * 3] = p >> 16;
+		bgr[p * 3 + 1] = p >> 8;
+		bgr[p * 3 + 2] = p;
+	}
+}
+
+int main(int argc, char **argv)
+{
+	int limit = argc > 1 ? atoi(argv[1]) : 0;
+	u8 *lut = malloc((size_t)NPIX * 3), *ref = malloc((size_t)NPIX * 3);
+	int s, fails = 0;
+
+	if (!lut || !ref)
+		return 1;
+
+	for (s = 0; s < (int)(sizeof(sets) / sizeof(sets[0])); s++) {
+		u64 sum = 0, over4 = 0;
+		int d, max = 0;
+		size_t i, worst = 0;
+
+		tm_bgr_target = sets[s].target;
+		tm_bgr_paper = sets[s].paper;
+		tm_bgr_gain = sets[s].gain;
+		tm_bgr_chroma = sets[s].chroma;
+		sc0710_tm_bgr_knobs_changed();
+
+		fill(ref);
+		tm_bgr_lut = 0;
+		sc0710_bgr24_sw_tonemap(ref, 4096, 4096);
+		fill(lut);
+		tm_bgr_lut = 1;
+		sc0710_bgr24_sw_tonemap(lut, 4096, 4096);
+
+		for (i = 0; i < (size_t)NPIX * 3; i++) {
+			d = abs((int)lut[i] - (int)ref[i]);
+			sum += d;
+			if (d > 4)
+				over4++;
+			if (d > max) {
+				max = d;
+				worst = i;
+			}
+		}
+
+		printf("%-8s max %3d  mean %.3f  >4: %.2f%%  worst in (%u,%u,%u)\n",
+		       sets[s].name, max, (double)sum / (NPIX * 3.0),
+		       100.0 * over4 / (NPIX * 3.0),
+		       (u32)(worst / 3) >> 16, ((u32)(worst / 3) >> 8) & 0xff,
+		       (u32)(worst / 3) & 0xff);
+		if (limit >= 0 && max > limit)
+			fails++;
+	}
+
+	free(lut);
+	free(ref);
+	return fails ? 1 : 0;
+}
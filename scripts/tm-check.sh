@@ -0,0 +1,99 @@
+#!/usr/bin/env bash
+# Copyright (C) 2025-2026 Nakildias <nakildiaspro@gmail.com>
+# SPDX-License-Identifier: GPL-2.0-or-later
+#
+# SC0710 host tonemap checks
+#
+# Builds lib/sc0710-tonemap.c in userspace against a few kernel shims and
+# runs one of the tonemap harnesses against it. Needs only a C compiler;
+# no kernel headers, no card.
+#
+# Usage:
+#   bash scripts/tm-check.sh yuyv-exact [rounds]    # table path == per-sample path
+#   bash scripts/tm-check.sh bgr-lut-error [max]    # cached tables == per-pixel curve, 2^24 inputs
+
+set -euo pipefail
+
+HERE="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+LIB="$HERE/../lib"
+CC="${CC:-cc}"
+
+case "${1:-}" in
+    yuyv-exact)    TEST="tm-yuyv-exact.c" ;;
+    bgr-lut-error) TEST="tm-bgr-lut-error.c" ;;
+    *)
+        echo "usage: $0 yuyv-exact|bgr-lut-error [args...]" >&2
+        exit 2
+        ;;
+esac
+shift
+
+TMP="$(mktemp -d)"
+trap 'rm -rf "$TMP"' EXIT
+
+# sc0710-tonemap.c includes "sc0710.h" from its own directory, so build it
+# from a copy next to a stand-in header rather than from lib/.
+cp "$LIB/sc0710-tonemap.c" "$LIB/sc0710-tonemap-luts.h" "$TMP/"
+mkdir -p "$TMP/linux"
+for h in types kernel unaligned atomic mutex; do
+    echo '#include "../sc0710.h"' > "$TMP/linux/$h.h"
+done
+
+cat > "$TMP/sc0710.h" <<'EOF'
+#ifndef SC0710_TM_SHIM_H
+#define SC0710_TM_SHIM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+typedef uint8_t u8;
+typedef uint16_t u16;
+typedef uint32_t u32;
+typedef uint64_t u64;
+typedef int16_t s16;
+
+#define unlikely(x)		__builtin_expect(!!(x), 0)
+
+static inline u64 get_unaligned_le64(const void *p)
+{
+	u64 v;
+
+	memcpy(&v, p, sizeof(v)); /* little-endian hosts only */
+	return v;
+}
+
+static inline void put_unaligned_le64(u64 v, void *p)
+{
+	memcpy(p, &v, sizeof(v));
+}
+
+typedef struct { int counter; } atomic_t;
+#define ATOMIC_INIT(i)		{ (i) }
+#define atomic_read(a)		((a)->counter)
+#define atomic_inc(a)		((a)->counter++)
+
+struct mutex { int unused; };
+#define DEFINE_MUTEX(m)		struct mutex m
+#define mutex_lock(m)		((void)(m))
+#define mutex_unlock(m)		((void)(m))
+
+#define smp_store_release(p, v)	(*(p) = (v))
+#define smp_load_acquire(p)	(*(p))
+
+extern int tm_yuyv_target, tm_paper_nits, tm_yuyv_gain, tm_yuyv_chroma;
+extern int tm_yuyv_black, tm_yuyv_white, tm_yuyv_u, tm_yuyv_v;
+extern int tm_yuyv_pq_bias, tm_yuyv_oetf;
+extern int tm_bgr_target, tm_bgr_paper, tm_bgr_gain, tm_bgr_chroma, tm_bgr_lut;
+
+void sc0710_tm_yuyv_knobs_changed(void);
+void sc0710_tm_bgr_knobs_changed(void);
+void sc0710_yuyv8_sw_tonemap(u8 *yuyv, u32 w, u32 h);
+void sc0710_bgr24_sw_tonemap(u8 *bgr, u32 w, u32 h);
+
+#endif
+EOF
+
+"$CC" -O2 -Wall -I"$TMP" -o "$TMP/test" "$HERE/$TEST"
+"$TMP/test" "$@"
@@ -0,0 +1,149 @@
+/*
+ * tm-yuyv-exact — the table-driven YUYV tonemap must be bit-exact.
+ *
+ * Runs sc0710_yuyv8_sw_tonemap() (cached per-code tables, 64-bit word
+ * loop) against the per-sample loop it replaced on random frames with
+ * random tm_yuyv_* knobs, including out-of-range knob values the setters
+ * clamp and frame sizes that end in a partial word.
+ *
+ * run: bash scripts/tm-check.sh yuyv-exact [rounds]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "sc0710-tonemap.c"
+
+int tm_yuyv_target = 80;
+int tm_paper_nits = 225;
+int tm_yuyv_gain = 100;
+int tm_yuyv_chroma = 300;
+int tm_yuyv_black;
+int tm_yuyv_white = 235;
+int tm_yuyv_u = 100;
+int tm_yuyv_v = 100;
+int tm_yuyv_pq_bias;
+int tm_yuyv_oetf;
+int tm_bgr_target = 50;
+int tm_bgr_paper = 400;
+int tm_bgr_gain = 150;
+int tm_bgr_chroma = 150;
+int tm_bgr_lut;
+
+/* The per-sample loop as it stood before the tables (commit 1113c6c^). */
+static void ref_yuyv8_sw_tonemap(u8 *yuyv, u32 w, u32 h)
+{
+	size_t i, n;
+	int target = sc0710_tm_clamp_int(tm_yuyv_target, 1, 100);
+	int paper = sc0710_tm_clamp_int(tm_paper_nits, 1, 10000);
+	int gain = sc0710_tm_clamp_int(tm_yuyv_gain, 1, 200);
+	int chroma = sc0710_tm_clamp_int(tm_yuyv_chroma, 0, 300);
+	int u_pct = sc0710_tm_clamp_int(tm_yuyv_u, 0, 200);
+	int v_pct = sc0710_tm_clamp_int(tm_yuyv_v, 0, 200);
+	int pq_bias = sc0710_tm_clamp_int(tm_yuyv_pq_bias, -64, 64);
+	int oetf = sc0710_tm_clamp_int(tm_yuyv_oetf, 0, 2);
+	int black = 16 + sc0710_tm_clamp_int(tm_yuyv_black, 0, 40);
+	int white = sc0710_tm_clamp_int(tm_yuyv_white, 180, 235);
+	int uscale = (chroma * u_pct * 256) / 10000;
+	int vscale = (chroma * v_pct * 256) / 10000;
+
+	if (!yuyv || w < 2 || !h)
+		return;
+	if (black > white)
+		black = white;
+
+	n = (size_t)w * h * 2;
+	for (i = 0; i + 3 < n; i += 4) {
+		int u = yuyv[i + 1];
+		int v = yuyv[i + 3];
+		int uo, vo;
+
+		yuyv[i] = sc0710_tm_yuyv_map_y(yuyv[i], target, paper, gain,
+					       black, white, pq_bias, oetf);
+		yuyv[i + 2] = sc0710_tm_yuyv_map_y(yuyv[i + 2], target, paper,
+						   gain, black, white, pq_bias,
+						   oetf);
+		uo = 128 + (((u - 128) * uscale) >> 8);
+		vo = 128 + (((v - 128) * vscale) >> 8);
+		if (uo < 0)
+			uo = 0;
+		else if (uo > 255)
+			uo = 255;
+		if (vo < 0)
+			vo = 0;
+		else if (vo > 255)
+			vo = 255;
+		yuyv[i + 1] = (u8)uo;
+		yuyv[i + 3] = (u8)vo;
+	}
+}
+
+/* Uniform in [lo, hi], with both ends reachable. */
+static int rnd(int lo, int hi)
+{
+	return lo + rand() % (hi - lo + 1);
+}
+
+static void random_knobs(void)
+{
+	/* ~1 in 8 draws lands outside the setter's clamp range. */
+	tm_yuyv_target = rnd(-10, 115);
+	tm_paper_nits = rnd(-50, 10500);
+	tm_yuyv_gain = rnd(-10, 220);
+	tm_yuyv_chroma = rnd(-10, 320);
+	tm_yuyv_black = rnd(-5, 45);
+	tm_yuyv_white = rnd(170, 240);
+	tm_yuyv_u = rnd(-10, 220);
+	tm_yuyv_v = rnd(-10, 220);
+	tm_yuyv_pq_bias = rnd(-70, 70);
+	tm_yuyv_oetf = rnd(-1, 3);
+	sc0710_tm_yuyv_knobs_changed();
+}
+
+int main(int argc, char **argv)
+{
+	static const u32 sizes[][2] = {
+		{ 1920, 1080 }, { 1280, 720 }, { 720, 480 },
+		{ 2, 1 }, { 6, 1 }, { 10, 3 }, { 34, 17 },
+	};
+	int rounds = argc > 1 ? atoi(argv[1]) : 200;
+	size_t max = (size_t)1920 * 1080 * 2;
+	u8 *a = malloc(max), *b = malloc(max);
+	int r, fails = 0;
+	size_t i, n;
+
+	if (!a || !b)
+		return 1;
+	srand(0x5c0710);
+
+	for (r = 0; r < rounds; r++) {
+		u32 w = sizes[r % 7][0], h = sizes[r % 7][1];
+
+		random_knobs();
+		n = (size_t)w * h * 2;
+		for (i = 0; i < n; i++)
+			a[i] = rand();
+		memcpy(b, a, n);
+
+		sc0710_yuyv8_sw_tonemap(a, w, h);
+		ref_yuyv8_sw_tonemap(b, w, h);
+
+		for (i = 0; i < n && a[i] == b[i]; i++)
+			;
+		if (i < n) {
+			fprintf(stderr,
+				"round %d (%ux%u): byte %zu table %u per-sample %u "
+				"(target %d paper %d gain %d chroma %d black %d "
+				"white %d u %d v %d bias %d oetf %d)\n",
+				r, w, h, i, a[i], b[i], tm_yuyv_target,
+				tm_paper_nits, tm_yuyv_gain, tm_yuyv_chroma,
+				tm_yuyv_black, tm_yuyv_white, tm_yuyv_u,
+				tm_yuyv_v, tm_yuyv_pq_bias, tm_yuyv_oetf);
+			fails++;
+		}
+	}
+
+	printf("yuyv-exact: %d/%d rounds bit-exact\n", rounds - fails, rounds);
+	free(a);
+	free(b);
+	return fails ? 1 : 0;
+}